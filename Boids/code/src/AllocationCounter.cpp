@@ -0,0 +1,13 @@
+#include "AllocationCounter.hpp"
+
+// For counting from any thread
+#include <atomic>
+
+// Relaxed, as counts are only read between steps, after workers joined in
+static std::atomic<size_t> allocationCount(0);
+
+void AllocationCounter::record()
+{allocationCount.fetch_add(1, std::memory_order_relaxed);}
+
+size_t AllocationCounter::getCount()
+{return allocationCount.load(std::memory_order_relaxed);}
@@ -0,0 +1,19 @@
+#ifndef ALLOCATION_COUNTER_HPP
+#define ALLOCATION_COUNTER_HPP
+
+// For the count
+#include <cstddef>
+
+// Process-wide count of heap allocations. Nothing is counted unless the
+// program's global operator new calls record(), as the benchmark tool's
+// does, so the count stays zero everywhere else
+namespace AllocationCounter
+{
+    // Count one allocation. Safe to call from any thread
+    void record();
+
+    // Get the amount of allocations counted so far
+    size_t getCount();
+}
+
+#endif
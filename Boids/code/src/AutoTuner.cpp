@@ -0,0 +1,210 @@
+#include "AutoTuner.hpp"
+
+// For the tuned world
+#include "BoidWorld.hpp"
+
+// For medians
+#include <algorithm>
+
+// For relative drift
+#include <cmath>
+
+// For hardware thread counts
+#include <thread>
+
+// Constructor
+
+AutoTuner::AutoTuner() :
+enabled(false), trialSteps(8), retuneThreshold(0.25f), log(nullptr),
+candidate(0), warmedUp(false), tuned(false), tunedBoidCount(0), 
+tunedSenseRadius(0), tunedNeighborMode(NeighborMode::Metric),
+chosen{SpatialIndex::BruteForce, 0, 1}, chosenSeconds(0),
+original{SpatialIndex::BruteForce, 0, 1}
+{}
+
+// Tuning
+
+void AutoTuner::beforeStep(BoidWorld& world)
+{
+    if (!this->enabled)
+    {
+        if (this->isTuning())
+            this->abandonTuning(world);
+
+        return;
+    }
+
+    if (!this->isTuning() && this->needsTuning(world))
+        this->startTuning(world);
+
+    if (!this->isTuning())
+        return;
+
+    // Move on once the current candidate has enough samples
+    if (this->samples.size() >= this->trialSteps)
+    {
+        std::nth_element(this->samples.begin(), 
+            this->samples.begin() + this->samples.size() / 2, this->samples.end());
+        this->candidateSeconds.push_back(this->samples[this->samples.size() / 2]);
+
+        this->samples.clear();
+        this->warmedUp = false;
+        ++this->candidate;
+
+        if (!this->isTuning())
+        {
+            this->finishTuning(world);
+            return;
+        }
+    }
+
+    if (this->samples.empty() && !this->warmedUp)
+        apply(world, this->candidates[this->candidate]);
+}
+
+void AutoTuner::afterStep(const BoidWorld&, double seconds, bool analyzed)
+{
+    if (!this->enabled || !this->isTuning() || analyzed)
+        return;
+
+    // The first step of a candidate pays for thread startup and cold caches
+    if (!this->warmedUp)
+        this->warmedUp = true;
+    else
+        this->samples.push_back(seconds);
+}
+
+bool AutoTuner::needsTuning(const BoidWorld& world) const
+{
+    if (!this->tuned)
+        return true;
+
+    auto drifted = [this](double now, double then)
+    {
+        return then == 0 ? now != 0 
+            : std::abs(now - then) / then > this->retuneThreshold;
+    };
+
+    return drifted(world.boids.size(), this->tunedBoidCount) 
+        || drifted(world.senseRadius, this->tunedSenseRadius)
+        || world.neighborMode != this->tunedNeighborMode;
+}
+
+void AutoTuner::startTuning(const BoidWorld& world)
+{
+    this->tunedBoidCount = world.boids.size();
+    this->tunedSenseRadius = world.senseRadius;
+    this->tunedNeighborMode = world.neighborMode;
+    this->original = {world.spatialIndex, world.gridCellSize, world.getThreadCount()};
+
+    // Serial, half and all of the hardware threads
+    size_t hardwareThreads = std::max(std::thread::hardware_concurrency(), 1u);
+    std::vector<size_t> threadCounts = {1};
+    if (hardwareThreads / 2 > 1)
+        threadCounts.push_back(hardwareThreads / 2);
+    if (hardwareThreads > 1)
+        threadCounts.push_back(hardwareThreads);
+
+    // Cells around senseRadius wide keep the scanned area small, while
+    // narrower ones trade more cells for fewer far-off candidates.
+    // Topological lookups go through the point tree whatever the layout,
+    // so they keep theirs, and sampled ones always go through the grid.
+    // Metric ones also try the hashed grid, which wins once boids spread
+    // far past the bounds, and the hierarchy, which wins once sense radii
+    // differ widely
+    float senseRadius = world.senseRadius;
+    std::vector<TunerConfig> layouts;
+    if (world.neighborMode == NeighborMode::Topological)
+        layouts = {{world.spatialIndex, world.gridCellSize, 0}};
+    else if (world.neighborMode == NeighborMode::Sampled)
+        layouts = {{SpatialIndex::Grid, senseRadius, 0}, 
+            {SpatialIndex::Grid, senseRadius / 2, 0}};
+    else
+        layouts = {{SpatialIndex::BruteForce, 0, 0}, 
+            {SpatialIndex::Grid, senseRadius, 0}, 
+            {SpatialIndex::Grid, senseRadius / 2, 0}, 
+            {SpatialIndex::HashedGrid, senseRadius, 0}, 
+            {SpatialIndex::Hierarchical, 0, 0}};
+
+    this->candidates.clear();
+    for (const TunerConfig& layout : layouts)
+        for (size_t threadCount : threadCounts)
+            this->candidates.push_back
+                ({layout.spatialIndex, layout.gridCellSize, threadCount});
+
+    this->candidateSeconds.clear();
+    this->samples.clear();
+    this->candidate = 0;
+    this->warmedUp = false;
+}
+
+void AutoTuner::apply(BoidWorld& world, const TunerConfig& config)
+{
+    world.spatialIndex = config.spatialIndex;
+    world.gridCellSize = config.gridCellSize;
+
+    if (world.getThreadCount() != config.threadCount)
+        world.setThreadCount(config.threadCount);
+}
+
+void AutoTuner::finishTuning(BoidWorld& world)
+{
+    size_t fastest = std::min_element(this->candidateSeconds.begin(), 
+        this->candidateSeconds.end()) - this->candidateSeconds.begin();
+
+    this->chosen = this->candidates[fastest];
+    this->chosenSeconds = this->candidateSeconds[fastest];
+    this->tuned = true;
+    apply(world, this->chosen);
+
+    if (this->log)
+    {
+        *this->log << "Auto-tuned for " << this->tunedBoidCount << " boids, "
+            << "senseRadius " << this->tunedSenseRadius << ": "
+            << (this->chosen.spatialIndex == SpatialIndex::Grid ? "grid" 
+                : this->chosen.spatialIndex == SpatialIndex::HashedGrid ? "hashed grid" 
+                : this->chosen.spatialIndex == SpatialIndex::Hierarchical ? "grid hierarchy" 
+                : "brute force");
+
+        if (this->chosen.spatialIndex != SpatialIndex::BruteForce)
+        {
+            if (this->chosen.gridCellSize == 0)
+                *this->log << " with automatic cells";
+            else
+                *this->log << " with " << this->chosen.gridCellSize << " px cells";
+        }
+
+        *this->log << ", " << this->chosen.threadCount << " threads, " 
+            << this->chosenSeconds * 1000.0 << " ms/step (" 
+            << this->candidates.size() << " candidates)" << std::endl;
+    }
+}
+
+void AutoTuner::abandonTuning(BoidWorld& world)
+{
+    apply(world, this->original);
+
+    // What tuning started for was already recorded, so only forgetting
+    // the outcome makes it start over once enabled again
+    this->tuned = false;
+
+    this->candidates.clear();
+    this->candidateSeconds.clear();
+    this->samples.clear();
+    this->candidate = 0;
+    this->warmedUp = false;
+
+    if (this->log)
+        *this->log << "Auto-tuning abandoned, configuration restored" << std::endl;
+}
+
+// Getters
+
+bool AutoTuner::isTuning() const
+{return this->candidate < this->candidates.size();}
+
+const TunerConfig& AutoTuner::getChosen() const
+{return this->chosen;}
+
+double AutoTuner::getChosenSeconds() const
+{return this->chosenSeconds;}
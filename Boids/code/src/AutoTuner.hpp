@@ -0,0 +1,107 @@
+#ifndef AUTO_TUNER_HPP
+#define AUTO_TUNER_HPP
+
+// For the tuning log
+#include <ostream>
+
+// For candidate configurations
+#include <vector>
+
+// For spatial index types
+#include "SteeringPolicy.hpp"
+
+// Forward declaration, only handled through references
+class BoidWorld;
+
+// Settings of a world that affect step time. They only leave behavior
+// untouched in deterministic mode: otherwise each index visits neighbors in
+// its own order, and steering sums round differently along each
+struct TunerConfig
+{
+    SpatialIndex spatialIndex;
+
+    // Zero picks one from the density of boids
+    float gridCellSize;
+
+    size_t threadCount;
+};
+
+// Times a few candidate configurations for a handful of steps each, then
+// locks in the fastest. Tuning starts over whenever the boid count,
+// senseRadius or neighbor mode drift too far from what was tuned for.
+// Disabling it midway puts back the configuration tuning started from,
+// and tuning starts over once it's enabled again
+class AutoTuner
+{
+    public:
+        // Whether the world's configuration is being managed
+        bool enabled;
+
+        // Steps timed per candidate, after one discarded warm-up step
+        size_t trialSteps;
+
+        // Relative change in boid count or senseRadius that triggers
+        // tuning again
+        float retuneThreshold;
+
+        // Where chosen configurations get reported, if anywhere
+        std::ostream* log;
+
+        // Default-construct a disabled tuner
+        AutoTuner();
+
+        // Apply the next configuration to time, if tuning, before a step.
+        // When disabled midway, put back the one tuning started from
+        void beforeStep(BoidWorld& world);
+
+        // Account for the duration of a step. Analyzed steps aren't
+        // comparable to plain ones, so they're left out
+        void afterStep(const BoidWorld& world, double seconds, bool analyzed);
+
+        // Check whether candidates are still being timed
+        bool isTuning() const;
+
+        // Get the latest configuration locked in
+        const TunerConfig& getChosen() const;
+
+        // Get the median step time of the latest configuration locked in
+        double getChosenSeconds() const;
+
+    private:
+        std::vector<TunerConfig> candidates;
+        std::vector<double> candidateSeconds;
+        size_t candidate;
+
+        // Step times of the candidate being timed
+        std::vector<double> samples;
+        bool warmedUp;
+
+        // What the chosen configuration was tuned for
+        bool tuned;
+        size_t tunedBoidCount;
+        float tunedSenseRadius;
+        NeighborMode tunedNeighborMode;
+
+        TunerConfig chosen;
+        double chosenSeconds;
+
+        // World configuration from before the latest tuning started
+        TunerConfig original;
+
+        // Check whether the world drifted away from what was tuned for
+        bool needsTuning(const BoidWorld& world) const;
+
+        // List the candidates for the world and start timing them
+        void startTuning(const BoidWorld& world);
+
+        // Set a configuration on the world
+        static void apply(BoidWorld& world, const TunerConfig& config);
+
+        // Lock in the fastest candidate
+        void finishTuning(BoidWorld& world);
+
+        // Stop timing candidates, putting the original configuration back
+        void abandonTuning(BoidWorld& world);
+};
+
+#endif
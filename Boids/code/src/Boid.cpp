@@ -1,35 +1,82 @@
 #include "Boid.hpp"
 
-// For global simulation parameters
-#include "BoidManager.hpp"
+// For simulation parameters
+#include "BoidWorld.hpp"
 
 // For quick vector math
 #include "QuickMath.hpp"
 
+// For neighbor sources
+#include "Neighbors.hpp"
+
+// For flock analytics
+#include "ConcurrentUnionFind.hpp"
+
+// For lazy steering
+#include "SteeringCache.hpp"
+
+// For predictive avoidance
+#include "CollisionAvoidance.hpp"
+
+// For trigonometry
+#include <cmath>
+
 Boid::Boid()
-: nextDir(0), updatedDir(false)
+: nextDir(0), updatedDir(false), desiredDir(0), hasDesiredDir(false),
+timeScale(1), senseRadius(0)
 {}
 
 Boid::~Boid()
 {}
 
-double Boid::distanceTo(const Boid& other)
-{
-    // Get the radial distance to the other boid's center
-    return QuickMath::getMagnitude
-        (other.getPosition() - this->getPosition());
-}
-
 // TODO(me): Fix bias towards 180°
-void Boid::updateRotation()
+template <typename Policy, typename Neighbors>
+void Boid::updateRotation
+    (const BoidWorld& world, size_t boid_index, SteeringContext& context)
 {
     // Asume no change will take place yet until proven
     // otherwise
     this->updatedDir = false;
+    this->hasDesiredDir = false;
+
+    // With every rule disabled there's nothing to look for
+    if constexpr (!Policy::any)
+        return;
 
     // Cache this boid's info
     sf::Vector2f currentPos = this->getPosition();
-    float currentDirection = this->getRotation();
+
+    // Look ahead for the earliest collision along the heading. Cached
+    // directions know nothing of what lies ahead, so they're only reused
+    // while nothing does
+    sf::Vector2f avoidanceF;
+    bool avoiding = Policy::steers && world.avoidanceC != 0
+        && CollisionAvoidance::steerAway(world, boid_index, avoidanceF);
+
+    // Reuse the latest desired direction while the surroundings look the
+    // same, only turning toward it again
+    SteeringCache* cache = Policy::steers && !avoiding ? context.steeringCache : nullptr;
+    SteeringCache::Signature signature;
+    BoidStorage::BoidId id = 0;
+
+    if (cache)
+    {
+        signature = cache->sign(world, boid_index);
+        id = world.boids.getId(boid_index);
+
+        float cachedDirection;
+        bool cachedSteers;
+        if (cache->lookup(id, signature, cachedDirection, cachedSteers))
+        {
+            ++context.cacheHits;
+            if (cachedSteers)
+                this->turnTowards(world, cachedDirection);
+
+            return;
+        }
+
+        ++context.cacheMisses;
+    }
 
     // Keep track the driving forces
     sf::Vector2f separationF, allignmentF, cohesionF;
@@ -38,79 +85,110 @@ void Boid::updateRotation()
     float avgRot = 0;
     sf::Vector2f avgPos = sf::Vector2f(0, 0);
 
-    // Consider all boids that happen to be ranged, in-view neighbors
-    // of this one
+    // Consider all boids that happen to be neighbors of this one, as
+    // defined by the neighbor source
     size_t consideredNeighbors = 0;
-    const Boid* boidArray = BoidManager::getInstance().boidArray;
-    const size_t& boidCount = BoidManager::getInstance().boidCount;
-    const double& senseRadius = BoidManager::getInstance().senseRadius;
+    const BoidStorage& boids = world.boids;
 
-    for (size_t boidIterator = 0; boidIterator < boidCount; ++boidIterator)
+    Neighbors::forEach(world, boid_index, context, 
+        [&](size_t neighbor_index, double neighbor_dist)
     {
-        // Don't consider itself as a neighbor
-        if (this == &boidArray[boidIterator])
-            continue;
-
-        // Check the distance to the current neighbor
-        double neighborDist = distanceTo(boidArray[boidIterator]);
-
-        // Only consider it if it doesn't exceed the maximum distance
-        // or is at least non-zero
-        if (neighborDist > senseRadius || neighborDist == 0)
-            continue;
-        
         ++consideredNeighbors;
 
+        // Link both boids into the same flock. Only one of the two visits
+        // needs to do it, unless the neighbor doesn't see this boid back
+        if constexpr (Policy::analytics)
+            if (neighbor_index > boid_index 
+                || neighbor_dist > boids[neighbor_index].getSenseRadius(world))
+                context.flockUnion->unite(boid_index, neighbor_index);
+
         // Cache neighbor info
-        sf::Vector2f neighborPos = boidArray[boidIterator].getPosition();
-        float neighborRot = boidArray[boidIterator].getRotation();
+        sf::Vector2f neighborPos = boids[neighbor_index].getPosition();
 
-        // Update the average position and rotation
-        avgPos += neighborPos;
-        avgRot += neighborRot;
+        // Update the average position and rotation, only for the rules
+        // that make use of them
+        if constexpr (Policy::cohesion)
+            avgPos += neighborPos;
+
+        if constexpr (Policy::allignment)
+            avgRot += boids[neighbor_index].getRotation();
 
         // Calculate the neighbor's offset for the separation force
         // And make it inversely proportional to the distance to the neighbor
-        sf::Vector2f offset = currentPos - neighborPos;
-        offset.x /= neighborDist; offset.y /= neighborDist;
-
-        separationF += offset;
-    }
-
-    if (consideredNeighbors == 0)
-        return;
+        if constexpr (Policy::separation)
+        {
+            sf::Vector2f offset = currentPos - neighborPos;
+            offset.x /= neighbor_dist; offset.y /= neighbor_dist;
 
-    // Compute averages
-    avgPos.x /= consideredNeighbors;
-    avgPos.y /= consideredNeighbors;
-    avgRot /= consideredNeighbors;
-    avgRot = QuickMath::degreesToRadians(avgRot);
+            separationF += offset;
+        }
+    });
 
-    // Compute forces
-    separationF.x /= consideredNeighbors;
-    separationF.y /= consideredNeighbors;
-    separationF = QuickMath::getNormalized(separationF) 
-        * BoidManager::getInstance().separationC;
+    if (!Policy::steers || (consideredNeighbors == 0 && !avoiding))
+    {
+        if (cache)
+            cache->store(id, signature, 0, false);
 
-    allignmentF.x = cos(avgRot);
-    allignmentF.y = sin(avgRot);
-    allignmentF = QuickMath::getNormalized(allignmentF) 
-        * BoidManager::getInstance().allignmentC;
+        return;
+    }
 
-    cohesionF = avgPos - currentPos;
-    cohesionF = QuickMath::getNormalized(cohesionF) 
-        * BoidManager::getInstance().cohesionC;
+    // Compute averages and forces for the rules in effect, when there are
+    // neighbors to average over
+    if (consideredNeighbors != 0)
+    {
+        if constexpr (Policy::separation)
+        {
+            separationF.x /= consideredNeighbors;
+            separationF.y /= consideredNeighbors;
+            separationF = QuickMath::getNormalized(separationF) 
+                * world.separationC;
+        }
+
+        if constexpr (Policy::allignment)
+        {
+            avgRot /= consideredNeighbors;
+            avgRot = QuickMath::degreesToRadians(avgRot);
+
+            allignmentF.x = cos(avgRot);
+            allignmentF.y = sin(avgRot);
+            allignmentF = QuickMath::getNormalized(allignmentF) 
+                * world.allignmentC;
+        }
+
+        if constexpr (Policy::cohesion)
+        {
+            avgPos.x /= consideredNeighbors;
+            avgPos.y /= consideredNeighbors;
+
+            cohesionF = avgPos - currentPos;
+            cohesionF = QuickMath::getNormalized(cohesionF) 
+                * world.cohesionC;
+        }
+    }
 
     // Compute desired direction as a vector sum of the forces,
     // then onto degrees
     float desiredDirection = QuickMath::getDegrees
-        (separationF + allignmentF + cohesionF);
+        (separationF + allignmentF + cohesionF + avoidanceF);
+
+    if (cache)
+        cache->store(id, signature, desiredDirection, true);
+
+    this->turnTowards(world, desiredDirection);
+}
+
+void Boid::turnTowards(const BoidWorld& world, float desired_direction)
+{
+    this->desiredDir = desired_direction;
+    this->hasDesiredDir = true;
+
+    float currentDirection = this->getRotation();
 
     // Compute the turning step and positive angle offset from
     // the desired direction
-    double turnStep = BoidManager::getInstance().turnSpeed;
+    double turnStep = world.turnSpeed * this->timeScale;
     
-    double directionOffset = desiredDirection - currentDirection;
+    double directionOffset = desired_direction - currentDirection;
     directionOffset = QuickMath::modulus(directionOffset, 0.0, 360.0);
 
     // Rotate forward or backward acordingly
@@ -118,13 +196,113 @@ void Boid::updateRotation()
     if (directionOffset > 180.0) turnStep *= -1;
 
     this->nextDir = QuickMath::clampAdvance
-        (currentDirection, desiredDirection, turnStep, 
-        std::function(QuickMath::differenceIsSignificant<float>));
+        (currentDirection, desired_direction, turnStep, 
+        QuickMath::differenceIsSignificant<float>);
     
     this->updatedDir = true;
 }
 
-void Boid::updatePosition()
+// Every combination of rules, indexed by
+// (separation << 2) | (allignment << 1) | cohesion, with one table per
+// feature set and neighbor source
+template <bool Analytics, typename Neighbors>
+static constexpr Boid::SteeringKernel policyKernels[] =
+{
+    &Boid::updateRotation<SteeringPolicy<false, false, false, Analytics>, Neighbors>,
+    &Boid::updateRotation<SteeringPolicy<false, false, true, Analytics>, Neighbors>,
+    &Boid::updateRotation<SteeringPolicy<false, true, false, Analytics>, Neighbors>,
+    &Boid::updateRotation<SteeringPolicy<false, true, true, Analytics>, Neighbors>,
+    &Boid::updateRotation<SteeringPolicy<true, false, false, Analytics>, Neighbors>,
+    &Boid::updateRotation<SteeringPolicy<true, false, true, Analytics>, Neighbors>,
+    &Boid::updateRotation<SteeringPolicy<true, true, false, Analytics>, Neighbors>,
+    &Boid::updateRotation<SteeringPolicy<true, true, true, Analytics>, Neighbors>
+};
+
+template <typename Neighbors>
+static Boid::SteeringKernel selectKernel(size_t kernel_index, bool analytics)
+{
+    return analytics ? policyKernels<true, Neighbors>[kernel_index] 
+        : policyKernels<false, Neighbors>[kernel_index];
+}
+
+Boid::SteeringKernel Boid::selectSteeringKernel
+    (const BoidWorld& world, bool analytics)
+{
+    size_t kernelIndex = (world.separationC != 0) << 2 
+        | (world.allignmentC != 0) << 1 | (world.cohesionC != 0);
+
+    // Sources are then picked through selectNeighborGather instead
+    if (world.deterministic)
+        return selectKernel<OrderedNeighbors>(kernelIndex, analytics);
+
+    if (world.neighborMode == NeighborMode::Topological)
+        return selectKernel<TopologicalNeighbors>(kernelIndex, analytics);
+
+    // Analyzed steps visit every neighbor, so flocks stay complete
+    if (world.neighborMode == NeighborMode::Sampled && !analytics)
+        return selectKernel<SampledNeighbors>(kernelIndex, analytics);
+
+    if (world.spatialIndex == SpatialIndex::Grid 
+        || world.neighborMode == NeighborMode::Sampled)
+        return selectKernel<GridNeighbors>(kernelIndex, analytics);
+
+    if (world.spatialIndex == SpatialIndex::HashedGrid)
+        return selectKernel<HashedNeighbors>(kernelIndex, analytics);
+
+    if (world.spatialIndex == SpatialIndex::Hierarchical)
+        return selectKernel<HierarchyNeighbors>(kernelIndex, analytics);
+
+    return selectKernel<BruteForceNeighbors>(kernelIndex, analytics);
+}
+
+NeighborGather Boid::selectNeighborGather(const BoidWorld& world, bool analytics)
+{
+    if (!world.deterministic)
+        return nullptr;
+
+    if (world.neighborMode == NeighborMode::Topological)
+        return &OrderedNeighbors::gather<TopologicalNeighbors>;
+
+    if (world.neighborMode == NeighborMode::Sampled && !analytics)
+        return &OrderedNeighbors::gather<SampledNeighbors>;
+
+    if (world.spatialIndex == SpatialIndex::Grid 
+        || world.neighborMode == NeighborMode::Sampled)
+        return &OrderedNeighbors::gather<GridNeighbors>;
+
+    if (world.spatialIndex == SpatialIndex::HashedGrid)
+        return &OrderedNeighbors::gather<HashedNeighbors>;
+
+    if (world.spatialIndex == SpatialIndex::Hierarchical)
+        return &OrderedNeighbors::gather<HierarchyNeighbors>;
+
+    return &OrderedNeighbors::gather<BruteForceNeighbors>;
+}
+
+float Boid::getDesiredDirection() const
+{return this->desiredDir;}
+
+bool Boid::hasDesiredDirection() const
+{return this->hasDesiredDir;}
+
+void Boid::setTimeScale(float time_scale)
+{this->timeScale = time_scale;}
+
+float Boid::getSenseRadius(const BoidWorld& world) const
+{return this->senseRadius > 0 ? this->senseRadius : world.senseRadius;}
+
+void Boid::setSenseRadius(float sense_radius)
+{this->senseRadius = sense_radius;}
+
+void Boid::keepTurning(const BoidWorld& world)
+{
+    if (this->hasDesiredDir)
+        this->turnTowards(world, this->desiredDir);
+    else
+        this->updatedDir = false;
+}
+
+void Boid::updatePosition(const BoidWorld& world)
 {
     // Update current rotation, if it was updated
     if (this->updatedDir)
@@ -136,10 +314,16 @@ void Boid::updatePosition()
 
     // Update cache'd position via offset
     currentPos += sf::Vector2f(cos(currentDir), sin(currentDir))
-        * BoidManager::getInstance().flySpeed;
+        * (world.flySpeed * this->timeScale);
+
+    // Re-adjust position if out of bounds, unless the world is unbounded
+    const sf::FloatRect& bounds = world.bounds;
+    if (!world.wrapAround)
+    {
+        this->setPosition(currentPos);
+        return;
+    }
 
-    // Re-adjust position if out of bounds
-    const sf::FloatRect& bounds = BoidManager::getInstance().bounds;
     if (currentPos.x < bounds.left)
     {
         float offset = bounds.left - currentPos.x;
@@ -169,3 +353,15 @@ void Boid::updatePosition()
     // Update real-position
     this->setPosition(currentPos);
 }
+
+float Boid::getHeading() const
+{return this->updatedDir ? this->nextDir : this->getRotation();}
+
+void Boid::restoreState(const sf::Vector2f& position, float heading)
+{
+    this->setPosition(position);
+    this->setRotation(heading);
+
+    this->updatedDir = false;
+    this->hasDesiredDir = false;
+}
@@ -4,19 +4,87 @@
 // For movement and rendering
 #include <SFML/Graphics.hpp>
 
+// For per-step state
+#include "SteeringContext.hpp"
+
+// For steering policies
+#include "SteeringPolicy.hpp"
+
+// Forward declaration to avoid circular dependency
+class BoidWorld;
+
 class Boid : public sf::Sprite
 {
     private:
         float nextDir;
         bool updatedDir;
-        double distanceTo(const Boid& other);
+
+        // Latest direction steering settled on, if any neighbors were found
+        float desiredDir;
+        bool hasDesiredDir;
+
+        // Steps covered by each turn and move, more than one for boids
+        // simulated at a reduced rate
+        float timeScale;
+
+        // How far this boid sees, zero for the world's senseRadius
+        float senseRadius;
+
+        // Turn a step toward a desired direction, on the next position update
+        void turnTowards(const BoidWorld& world, float desired_direction);
 
     public:
+        // Steering update specialized for a given policy
+        using SteeringKernel = void (Boid::*)
+            (const BoidWorld& world, size_t boid_index, SteeringContext& context);
+
         Boid();
         ~Boid();
 
-        void updateRotation();
-        void updatePosition();
+        // Get the pre-instantiated steering update matching the world's
+        // neighbor mode, the rules whose coefficients are non-zero, and the
+        // features requested
+        static SteeringKernel selectSteeringKernel
+            (const BoidWorld& world, bool analytics);
+
+        // Get what gathers neighbors for the deterministic steering
+        // kernels, or null when the world isn't deterministic
+        static NeighborGather selectNeighborGather
+            (const BoidWorld& world, bool analytics);
+
+        // Steer by the neighbors the given source yields
+        template <typename Policy, typename Neighbors>
+        void updateRotation
+            (const BoidWorld& world, size_t boid_index, SteeringContext& context);
+
+        // Get the latest direction steering settled on, and whether it
+        // found any neighbors to settle on one
+        float getDesiredDirection() const;
+        bool hasDesiredDirection() const;
+
+        // Set the amount of steps each turn and move covers
+        void setTimeScale(float time_scale);
+
+        // Get how far this boid sees, its own radius if it has one or the
+        // world's otherwise
+        float getSenseRadius(const BoidWorld& world) const;
+
+        // Give this boid a radius of its own, or zero to follow the world's
+        void setSenseRadius(float sense_radius);
+
+        // Keep turning toward the latest desired direction, for steps where
+        // this boid isn't steered
+        void keepTurning(const BoidWorld& world);
+
+        void updatePosition(const BoidWorld& world);
+
+        // Get the direction the boid flies in on its next move, which is
+        // its rotation unless a turn is pending
+        float getHeading() const;
+
+        // Put the boid back at a recorded position and heading, forgetting
+        // any pending turn and desired direction
+        void restoreState(const sf::Vector2f& position, float heading);
 };
 
 #endif
@@ -1,17 +1,19 @@
 #include "BoidManager.hpp"
 
+// For the singleton instance
+#include <memory>
+
+// For clamping ranges
+#include <algorithm>
+
 // Constructor & Destructor
 
 BoidManager::BoidManager() :
-texture(new sf::Texture()), boidScale(1),
-boidCount(0), boidArray(nullptr),
-flySpeed(1), senseRadius(1), turnSpeed(90),
-separationC(1), allignmentC(1), cohesionC(1)
+boidScale(1), texture(new sf::Texture())
 {}
 
 BoidManager::~BoidManager()
 {
-    delete boidArray;
     delete texture;
 }
 
@@ -39,77 +41,39 @@ bool BoidManager::setTexture(const std::string& texture_path)
         return false;
 }
 
-bool BoidManager::setBounds(const sf::FloatRect& screen_bounds)
-{
-    if (screen_bounds.width == 0 || screen_bounds.height == 0)
-        return false;
-
-    else
-    {
-        this->bounds = screen_bounds;
-        return true;
-    }
-    
-}
+const sf::Texture* BoidManager::getTexture() const
+{return this->texture;}
 
-bool BoidManager::setBoidCount(const size_t boid_count)
+void BoidManager::addBoids(const size_t boid_count,
+    std::vector<BoidStorage::BoidId>* added_ids)
 {
-    if (boid_count == 0)
-        return false;
-    
-    // Discard all previous boids and create new ones
-    delete this->boidArray;
-    this->boidCount = boid_count; this->boidArray = new Boid[boidCount];
-
-    // Reset every boid's texture and transform origin
-    this->resetBoidsTexture();
-
-    // Give each a random starting position and rotation
-    sf::Vector2f randPos;
-    float randDir;
-    for (size_t boidIter = 0; boidIter < this->boidCount; ++boidIter)
-    {
-        randPos.x = this->bounds.left + (rand() % (unsigned)(this->bounds.width)); 
-        randPos.y = this->bounds.top + (rand() % (unsigned)(this->bounds.height));
-        randDir = rand() % 360;
-
-        this->boidArray[boidIter].setPosition(randPos);
-        this->boidArray[boidIter].setRotation(randDir);
-    }
+    // New boids are appended, so only those need their texture set
+    size_t firstNew = this->boids.size();
+    BoidWorld::addBoids(boid_count, added_ids);
 
-    return true;
+    this->resetBoidsTexture(firstNew);
 }
 
-// Rendering and simulation updating
-
-void BoidManager::update()
-{
-    // Move every boid first
-    for (size_t boidIter = 0; boidIter < boidCount; ++boidIter)
-        boidArray[boidIter].updatePosition();
-    
-    // Update each and every boid's momentum
-    for (size_t boidIter = 0; boidIter < boidCount; ++boidIter)
-        boidArray[boidIter].updateRotation();
-}
+// Rendering
 
-void BoidManager::resetBoidsTexture()
+void BoidManager::resetBoidsTexture(size_t begin, size_t end)
 {
-    for (size_t boidIter = 0; boidIter < boidCount; ++boidIter)
+    end = std::min(end, boids.size());
+    for (size_t boidIter = begin; boidIter < end; ++boidIter)
     {
-        boidArray[boidIter].setTexture(*(this->texture), true);
-        boidArray[boidIter].setScale(sf::Vector2f(1,1) * this->boidScale);
+        boids[boidIter].setTexture(*(this->texture), true);
+        boids[boidIter].setScale(sf::Vector2f(1,1) * this->boidScale);
 
-        sf::FloatRect localBounds = boidArray[boidIter].getLocalBounds();
-        this->boidArray[boidIter].
+        sf::FloatRect localBounds = boids[boidIter].getLocalBounds();
+        this->boids[boidIter].
             setOrigin(localBounds.width / 2.f, localBounds.height / 2.f);
     }
 }
 
 void BoidManager::draw(sf::RenderTarget& target, sf::RenderStates states) const
 {
-    for (size_t boidIter = 0; boidIter < boidCount; ++boidIter)
-        target.draw(boidArray[boidIter], states);
+    for (size_t boidIter = 0; boidIter < boids.size(); ++boidIter)
+        target.draw(boids[boidIter], states);
 }
 
 void BoidManager::freeTexture()
@@ -4,32 +4,16 @@
 // For rendering
 #include <SFML/Graphics.hpp>
 
-// For Boids
-#include "Boid.hpp"
+// For the simulation itself
+#include "BoidWorld.hpp"
 
-// Forward declaration to avoid circular dependency
-class Boid;
-
-class BoidManager : public sf::Drawable
+// Process-wide world that is also rendered on screen
+class BoidManager : public BoidWorld, public sf::Drawable
 {
     public:
         // Rendering parameters
         float boidScale;
 
-        // Simulation parameters
-        sf::FloatRect bounds;
-        float turnSpeed;
-        float flySpeed;
-        float senseRadius;
-
-        float separationC;
-        float allignmentC;
-        float cohesionC;
-
-        // Boid collection
-        size_t boidCount;
-        Boid* boidArray;
-
         // Forbid any copy-construction or copy-assignment
         BoidManager(BoidManager const&) = delete;
         BoidManager& operator=(BoidManager const&) = delete;
@@ -43,14 +27,12 @@ class BoidManager : public sf::Drawable
         // Set the current texture for boids
         bool setTexture(const std::string& texture_path);
 
-        // Set the screen bounds for boids
-        bool setBounds(const sf::FloatRect& screen_bounds);
-
-        // Set the current boid count
-        bool setBoidCount(const size_t boid_count);
+        // Get the current texture for boids
+        const sf::Texture* getTexture() const;
 
-        // Update the simulation
-        void update();
+        // Spawn textured boids
+        virtual void addBoids(const size_t boid_count,
+            std::vector<BoidStorage::BoidId>* added_ids = nullptr) override;
 
         // Draw all boids
         virtual void draw(sf::RenderTarget& target, sf::RenderStates states) const override;
@@ -69,8 +51,9 @@ class BoidManager : public sf::Drawable
         // Default-construct a BoidManager
         BoidManager();
 
-        // Update boids texture and center after texture swap
-        void resetBoidsTexture();
+        // Update the texture and center of the boids within [begin, end),
+        // or of every boid after a texture swap
+        void resetBoidsTexture(size_t begin = 0, size_t end = SIZE_MAX);
 };
 
 #endif
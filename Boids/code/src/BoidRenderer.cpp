@@ -0,0 +1,158 @@
+#include "BoidRenderer.hpp"
+
+// For clamping cell ranges
+#include <algorithm>
+
+// For rotations
+#include "QuickMath.hpp"
+
+// For timing trails
+#include <chrono>
+
+// Constructor
+
+BoidRenderer::BoidRenderer() :
+boidScale(1), cullCellSize(64), trailColor(255, 255, 255, 160), 
+texture(nullptr), visibleCount(0), totalCount(0), trailSeconds(0)
+{}
+
+// Setters
+
+void BoidRenderer::setTexture(const sf::Texture* boid_texture)
+{this->texture = boid_texture;}
+
+// Getters
+
+size_t BoidRenderer::getVisibleCount() const
+{return this->visibleCount;}
+
+size_t BoidRenderer::getTotalCount() const
+{return this->totalCount;}
+
+double BoidRenderer::getTrailSeconds() const
+{return this->trailSeconds;}
+
+size_t BoidRenderer::getTrailMemoryBytes() const
+{return this->trailVertices.capacity() * sizeof(sf::Vertex);}
+
+// Rendering
+
+void BoidRenderer::build(const BoidSnapshot& snapshot, const sf::FloatRect& visible_area)
+{
+    this->totalCount = snapshot.positions.size();
+    this->visibleCount = 0;
+    this->vertices.clear();
+    this->trailVertices.clear();
+    this->visibleBoids.clear();
+
+    // Texture corners, centered on the texture like the boids' origin
+    sf::Vector2f textureSize = this->texture 
+        ? sf::Vector2f(this->texture->getSize()) : sf::Vector2f(1, 1);
+    sf::Vector2f halfSize = textureSize * 0.5f * this->boidScale;
+
+    // Boids poke out of their cell by up to their rotated half diagonal
+    float margin = QuickMath::getMagnitude(halfSize);
+
+    // Bin boids by cell
+    const sf::FloatRect& bounds = snapshot.bounds;
+    this->cullGrid.build(snapshot.positions, bounds, this->cullCellSize);
+    const std::vector<uint32_t>& cellBoids = this->cullGrid.getSortedIndices();
+
+    // Visit only the cells overlapping the visible area, widened by the margin
+    size_t firstColumn = this->cullGrid.columnOf(visible_area.left - margin);
+    size_t lastColumn = this->cullGrid.columnOf
+        (visible_area.left + visible_area.width + margin);
+    size_t firstRow = this->cullGrid.rowOf(visible_area.top - margin);
+    size_t lastRow = this->cullGrid.rowOf
+        (visible_area.top + visible_area.height + margin);
+
+    for (size_t row = firstRow; row <= lastRow; ++row)
+    for (size_t column = firstColumn; column <= lastColumn; ++column)
+    {
+        size_t cell = row * this->cullGrid.getColumns() + column;
+        for (size_t sortedIter = this->cullGrid.cellBegin(cell); 
+            sortedIter < this->cullGrid.cellEnd(cell); ++sortedIter)
+        {
+            this->visibleBoids.push_back(cellBoids[sortedIter]);
+            this->emitBoid(snapshot, cellBoids[sortedIter], halfSize, textureSize);
+        }
+    }
+
+    // Trails of the visible boids go into their own batch of lines
+    auto trailStart = std::chrono::steady_clock::now();
+    if (snapshot.trailLength > 1)
+    {
+        float maxSegment = std::min(bounds.width, bounds.height) / 2;
+        this->trailVertices.reserve
+            (this->visibleBoids.size() * (snapshot.trailLength - 1) * 2);
+
+        for (size_t boidIndex : this->visibleBoids)
+            this->emitTrail(snapshot, boidIndex, maxSegment);
+    }
+
+    auto trailEnd = std::chrono::steady_clock::now();
+    this->trailSeconds = std::chrono::duration<double>(trailEnd - trailStart).count();
+}
+
+void BoidRenderer::emitBoid(const BoidSnapshot& snapshot, size_t boid_index,
+    const sf::Vector2f& half_size, const sf::Vector2f& texture_size)
+{
+    const sf::Vector2f corners[4] = {{-half_size.x, -half_size.y}, 
+        {half_size.x, -half_size.y}, {half_size.x, half_size.y}, {-half_size.x, half_size.y}};
+    const sf::Vector2f texCoords[4] = 
+        {{0, 0}, {texture_size.x, 0}, {texture_size.x, texture_size.y}, {0, texture_size.y}};
+
+    // Two triangles per boid
+    const size_t cornerOrder[6] = {0, 1, 2, 0, 2, 3};
+
+    const sf::Vector2f& position = snapshot.positions[boid_index];
+    float direction = QuickMath::degreesToRadians(snapshot.rotations[boid_index]);
+    float cosine = std::cos(direction), sine = std::sin(direction);
+
+    for (size_t vertexIter = 0; vertexIter < 6; ++vertexIter)
+    {
+        const sf::Vector2f& corner = corners[cornerOrder[vertexIter]];
+        sf::Vector2f offset(corner.x * cosine - corner.y * sine, 
+            corner.x * sine + corner.y * cosine);
+
+        this->vertices.emplace_back(position + offset, 
+            sf::Color::White, texCoords[cornerOrder[vertexIter]]);
+    }
+
+    ++this->visibleCount;
+}
+
+void BoidRenderer::emitTrail(const BoidSnapshot& snapshot, size_t boid_index, 
+    float max_segment)
+{
+    size_t length = snapshot.trailLength;
+    const sf::Vector2f* trail = &snapshot.trails[boid_index * length];
+
+    // Fade in from fully transparent at the oldest position
+    for (size_t segment = 0; segment + 1 < length; ++segment)
+    {
+        sf::Vector2f offset = trail[segment + 1] - trail[segment];
+        if (std::abs(offset.x) > max_segment || std::abs(offset.y) > max_segment)
+            continue;
+
+        sf::Color older = this->trailColor, newer = this->trailColor;
+        older.a = this->trailColor.a * segment / (length - 1);
+        newer.a = this->trailColor.a * (segment + 1) / (length - 1);
+
+        this->trailVertices.emplace_back(trail[segment], older);
+        this->trailVertices.emplace_back(trail[segment + 1], newer);
+    }
+}
+
+void BoidRenderer::draw(sf::RenderTarget& target, sf::RenderStates states) const
+{
+    if (!this->trailVertices.empty())
+        target.draw(this->trailVertices.data(), this->trailVertices.size(), 
+            sf::Lines, states);
+
+    if (this->vertices.empty())
+        return;
+
+    states.texture = this->texture;
+    target.draw(this->vertices.data(), this->vertices.size(), sf::Triangles, states);
+}
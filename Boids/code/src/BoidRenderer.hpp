@@ -0,0 +1,81 @@
+#ifndef BOID_RENDERER_HPP
+#define BOID_RENDERER_HPP
+
+// For rendering
+#include <SFML/Graphics.hpp>
+
+// For vertices
+#include <vector>
+
+// For the state being drawn
+#include "BoidSnapshot.hpp"
+
+// For culling by cell
+#include "UniformGrid.hpp"
+
+// Draws the boids of a snapshot as textured triangles in a single call.
+// Boids are binned into coarse world cells first, so only those in cells
+// overlapping the visible area get vertices
+class BoidRenderer : public sf::Drawable
+{
+    public:
+        // Scale applied to the texture of every boid
+        float boidScale;
+
+        // Side of the culling cells, in world units
+        float cullCellSize;
+
+        // Color of the newest end of trails, fading out towards the oldest
+        sf::Color trailColor;
+
+        // Default-construct without a texture
+        BoidRenderer();
+
+        // Set the texture shared by every boid. It must outlive the renderer
+        void setTexture(const sf::Texture* boid_texture);
+
+        // Rebuild the vertices from the boids of a snapshot that may be
+        // seen within the visible area
+        void build(const BoidSnapshot& snapshot, const sf::FloatRect& visible_area);
+
+        // Get the amount of boids given vertices by the latest build
+        size_t getVisibleCount() const;
+
+        // Get the amount of boids in the latest built snapshot
+        size_t getTotalCount() const;
+
+        // Get the time spent building trail vertices in the latest build
+        double getTrailSeconds() const;
+
+        // Get the memory held by trail vertices
+        size_t getTrailMemoryBytes() const;
+
+        // Draw the latest built vertices
+        virtual void draw(sf::RenderTarget& target, sf::RenderStates states) const override;
+
+    private:
+        const sf::Texture* texture;
+        std::vector<sf::Vertex> vertices;
+        std::vector<sf::Vertex> trailVertices;
+
+        size_t visibleCount;
+        size_t totalCount;
+        double trailSeconds;
+
+        // Indices of the boids given vertices by the latest build
+        std::vector<size_t> visibleBoids;
+
+        // Boids binned by culling cell. Reused across builds
+        UniformGrid cullGrid;
+
+        // Append the vertices of a single boid
+        void emitBoid(const BoidSnapshot& snapshot, size_t boid_index,
+            const sf::Vector2f& half_size, const sf::Vector2f& texture_size);
+
+        // Append the line segments of a single boid's trail, skipping those
+        // longer than the given length, which wrapped around the world
+        void emitTrail(const BoidSnapshot& snapshot, size_t boid_index, 
+            float max_segment);
+};
+
+#endif
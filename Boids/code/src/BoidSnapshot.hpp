@@ -0,0 +1,80 @@
+#ifndef BOID_SNAPSHOT_HPP
+#define BOID_SNAPSHOT_HPP
+
+// For positions
+#include <SFML/Graphics.hpp>
+
+// For per-boid state
+#include <vector>
+
+// For the density heatmap
+#include "DensityField.hpp"
+
+// Copy of everything needed to draw a simulation step, detached from the
+// world so that it can be rendered while the next step is computed
+struct BoidSnapshot
+{
+    // Step the snapshot was taken after
+    size_t step = 0;
+
+    // Duration of that step
+    double stepSeconds = 0;
+
+    // World area boids live in
+    sf::FloatRect bounds;
+
+    // Per-boid transforms
+    std::vector<sf::Vector2f> positions;
+    std::vector<float> rotations;
+
+    // Positions kept per boid trail, and the trails themselves, boid after
+    // boid and oldest first. Empty when trails are disabled
+    size_t trailLength = 0;
+    std::vector<sf::Vector2f> trails;
+
+    // Memory held by the world's trail history
+    size_t trailHistoryBytes = 0;
+
+    // Density and heading heatmap, if enabled
+    DensityField density;
+
+    // Flock structure as of the latest analyzed step
+    size_t analyzedStep = 0;
+    size_t flockCount = 0;
+    size_t largestFlock = 0;
+    float polarization = 0;
+    double analyticsOverhead = 0;
+
+    // Boids moved during the step, and chunks simulated at full rate, when
+    // chunks are enabled
+    bool chunked = false;
+    size_t steppedBoids = 0;
+    size_t nearChunks = 0;
+    size_t totalChunks = 0;
+
+    // Ratio of the busiest worker's steering time to the average one, and
+    // whether workers steered by region
+    double steerImbalance = 1;
+    bool decomposed = false;
+
+    // Steps it takes to steer every boid once
+    size_t steeringPhases = 1;
+
+    // Steps held by the world's history, and the memory they take, when
+    // recording
+    bool recordingHistory = false;
+    size_t historyFirstStep = 0;
+    size_t historyLastStep = 0;
+    size_t historyBytes = 0;
+
+    // Whether trajectories are being written to disk, and how much was
+    bool recordingTrajectory = false;
+    size_t trajectoryBytes = 0;
+
+    // Steering directions reused or recomputed during the latest lazy step
+    bool lazySteering = false;
+    size_t steeringHits = 0;
+    size_t steeringMisses = 0;
+};
+
+#endif
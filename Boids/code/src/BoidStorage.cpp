@@ -0,0 +1,92 @@
+#include "BoidStorage.hpp"
+
+// Constructor
+
+BoidStorage::BoidStorage() :
+count(0)
+{}
+
+// Access
+
+size_t BoidStorage::size() const
+{return this->count;}
+
+Boid& BoidStorage::operator[](size_t index)
+{return this->chunks[index >> chunkShift][index & (chunkSize - 1)];}
+
+const Boid& BoidStorage::operator[](size_t index) const
+{return this->chunks[index >> chunkShift][index & (chunkSize - 1)];}
+
+BoidStorage::BoidId BoidStorage::getId(size_t index) const
+{return this->indexIds[index];}
+
+size_t BoidStorage::getIndex(BoidId id) const
+{return this->idIndices[id];}
+
+bool BoidStorage::contains(BoidId id) const
+{return id < this->idIndices.size() && this->idIndices[id] != invalidId;}
+
+size_t BoidStorage::getIdCapacity() const
+{return this->idIndices.size();}
+
+// Adding and removing
+
+BoidStorage::BoidId BoidStorage::add()
+{
+    // Grow by a whole chunk when the last one is full
+    if (this->count == this->chunks.size() * chunkSize)
+        this->chunks.emplace_back(new Boid[chunkSize]);
+
+    // Recycle a free id if there's one
+    BoidId id;
+    if (!this->freeIds.empty())
+    {
+        id = this->freeIds.back();
+        this->freeIds.pop_back();
+    }
+
+    else
+    {
+        id = this->idIndices.size();
+        this->idIndices.push_back(invalidId);
+    }
+
+    // Slots may hold a previously removed boid, so start over
+    size_t index = this->count++;
+    (*this)[index] = Boid();
+
+    this->indexIds.push_back(id);
+    this->idIndices[id] = index;
+    return id;
+}
+
+bool BoidStorage::remove(BoidId id)
+{
+    if (!this->contains(id))
+        return false;
+
+    // Fill the hole with the last boid, which keeps its id
+    size_t index = this->idIndices[id];
+    size_t last = --this->count;
+    if (index != last)
+    {
+        BoidId lastId = this->indexIds[last];
+
+        (*this)[index] = (*this)[last];
+        this->indexIds[index] = lastId;
+        this->idIndices[lastId] = index;
+    }
+
+    this->indexIds.pop_back();
+    this->idIndices[id] = invalidId;
+    this->freeIds.push_back(id);
+    return true;
+}
+
+void BoidStorage::clear()
+{
+    this->count = 0;
+    this->indexIds.clear();
+    this->idIndices.clear();
+    this->freeIds.clear();
+}
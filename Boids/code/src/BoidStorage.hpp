@@ -0,0 +1,77 @@
+#ifndef BOID_STORAGE_HPP
+#define BOID_STORAGE_HPP
+
+// For ids
+#include <cstdint>
+
+// For chunks and lookup tables
+#include <memory>
+#include <vector>
+
+// For Boids
+#include "Boid.hpp"
+
+// Densely packed boids with stable ids. Boids live in fixed-size chunks
+// that never move, so adding boids never relocates existing ones. Removal
+// moves the last boid into the hole, and an id table keeps track of where
+// every boid currently sits. Both cost O(1) per boid
+class BoidStorage
+{
+    public:
+        // Identifier that stays with a boid for as long as it lives
+        using BoidId = uint32_t;
+        static constexpr BoidId invalidId = UINT32_MAX;
+
+        // Boids per chunk. A power of two, so lookup is a shift and a mask
+        static constexpr size_t chunkShift = 10;
+        static constexpr size_t chunkSize = size_t(1) << chunkShift;
+
+        // Default-construct an empty storage
+        BoidStorage();
+
+        // Forbid any copy-construction or copy-assignment
+        BoidStorage(BoidStorage const&) = delete;
+        BoidStorage& operator=(BoidStorage const&) = delete;
+
+        // Get the amount of live boids
+        size_t size() const;
+
+        // Access a live boid by its dense index, in [0, size())
+        Boid& operator[](size_t index);
+        const Boid& operator[](size_t index) const;
+
+        // Append a default boid at index size(), and get its id
+        BoidId add();
+
+        // Remove a boid, moving the last one into its place. False if the
+        // id doesn't belong to a live boid
+        bool remove(BoidId id);
+
+        // Remove every boid. Chunks are kept for reuse
+        void clear();
+
+        // Get the id of the boid at a dense index
+        BoidId getId(size_t index) const;
+
+        // Get the dense index of a live boid
+        size_t getIndex(BoidId id) const;
+
+        // Check whether an id belongs to a live boid
+        bool contains(BoidId id) const;
+
+        // Get one past the largest id handed out so far
+        size_t getIdCapacity() const;
+
+    private:
+        std::vector<std::unique_ptr<Boid[]>> chunks;
+        size_t count;
+
+        // Dense index to id, and id to dense index
+        std::vector<BoidId> indexIds;
+        std::vector<uint32_t> idIndices;
+
+        // Ids of removed boids, handed out again before new ones
+        std::vector<BoidId> freeIds;
+};
+
+#endif
@@ -0,0 +1,573 @@
+#include "BoidWorld.hpp"
+
+// For timing steps
+#include <chrono>
+
+// For reproducible placement of new boids
+#include "Random.hpp"
+
+// For headings
+#include "QuickMath.hpp"
+
+// For clamping the grid's cell size
+#include <algorithm>
+
+// Constructor & Destructor
+
+BoidWorld::BoidWorld() :
+turnSpeed(90), flySpeed(1), senseRadius(1),
+separationC(1), allignmentC(1), cohesionC(1),
+avoidanceC(0), lookAheadSteps(30), collisionDistance(6),
+neighborMode(NeighborMode::Metric), spatialIndex(SpatialIndex::BruteForce), 
+deterministic(false), lazySteering(false), sampleCount(16), 
+steeringPhases(1), stepBudget(0), maxSteeringPhases(16), topologicalCount(7), gridCellSize(0),
+wrapAround(true), seed(0), stepCount(0),
+lastStepSeconds(0), steppedBoids(0), spawnCount(0), steerSecondsPerBoid(0), otherStepSeconds(0), 
+contexts(1)
+{}
+
+BoidWorld::~BoidWorld()
+{}
+
+// Setters
+
+bool BoidWorld::setBounds(const sf::FloatRect& screen_bounds)
+{
+    if (screen_bounds.width == 0 || screen_bounds.height == 0)
+        return false;
+
+    else
+    {
+        this->bounds = screen_bounds;
+        return true;
+    }
+    
+}
+
+bool BoidWorld::setBoidCount(const size_t boid_count)
+{
+    if (boid_count == 0)
+        return false;
+    
+    // Discard all previous boids and create new ones, numbering draws from
+    // the seed all over again
+    this->boids.clear();
+    this->spawnCount = 0;
+    this->stepCount = 0;
+
+    this->addBoids(boid_count);
+    return true;
+}
+
+void BoidWorld::addBoids(const size_t boid_count,
+    std::vector<BoidStorage::BoidId>* added_ids)
+{
+    // Bookkeeping is cheap and sequential, placement happens afterwards
+    size_t firstNew = this->boids.size();
+    for (size_t boidIter = 0; boidIter < boid_count; ++boidIter)
+    {
+        BoidStorage::BoidId id = this->boids.add();
+        if (added_ids)
+            added_ids->push_back(id);
+    }
+
+    bool resetTrails = this->trails.getLength() != 0;
+    if (resetTrails)
+        this->trails.reserveIds(this->boids.getIdCapacity());
+
+    // Give each a random starting position and rotation. Draws only depend
+    // on the seed and on how many boids were spawned before, so the result
+    // is the same no matter how the work is split
+    uint64_t firstSpawn = this->spawnCount;
+    this->forEachRange(boid_count, [&](size_t begin, size_t end, size_t)
+    {
+        for (size_t newIter = begin; newIter < end; ++newIter)
+        {
+            uint64_t spawn = firstSpawn + newIter;
+            uint64_t positionBits = Random::philox(spawn * 2, this->seed);
+            uint64_t directionBits = Random::philox(spawn * 2 + 1, this->seed);
+
+            sf::Vector2f randPos
+                (Random::uniform(positionBits, bounds.left, bounds.left + bounds.width),
+                Random::uniform(positionBits >> 32, bounds.top, bounds.top + bounds.height));
+
+            Boid& boid = this->boids[firstNew + newIter];
+            boid.setPosition(randPos);
+            boid.setRotation(Random::uniform(directionBits, 0, 360));
+
+            // Ids may be recycled, so forget whatever their previous boid
+            // steered toward
+            steeringCache.invalidate(this->boids.getId(firstNew + newIter));
+
+            // Start trails where the boid spawned
+            if (resetTrails)
+                this->trails.resetTrail(this->boids.getId(firstNew + newIter), randPos);
+        }
+    });
+
+    this->spawnCount += boid_count;
+}
+
+size_t BoidWorld::removeBoids(const std::vector<BoidStorage::BoidId>& boid_ids)
+{
+    size_t removed = 0;
+    for (BoidStorage::BoidId id : boid_ids)
+        removed += this->boids.remove(id);
+
+    return removed;
+}
+
+// Trails
+
+void BoidWorld::setTrailLength(size_t trail_length)
+{
+    this->trails.setLength(trail_length, this->boids.getIdCapacity());
+
+    if (trail_length != 0)
+        for (size_t boidIter = 0; boidIter < this->boids.size(); ++boidIter)
+            this->trails.resetTrail(this->boids.getId(boidIter), 
+                this->boids[boidIter].getPosition());
+}
+
+// Threading
+
+void BoidWorld::setThreadCount(size_t thread_count)
+{
+    this->pool.reset();
+    if (thread_count != 1)
+        this->pool.reset(new ThreadPool(thread_count));
+
+    this->contexts.assign(this->getThreadCount(), SteeringContext());
+}
+
+size_t BoidWorld::getThreadCount() const
+{return this->pool ? this->pool->getThreadCount() : 1;}
+
+void BoidWorld::forEachRange(size_t count, ThreadPool::RangeFunction body)
+{
+    if (this->pool)
+        this->pool->parallelFor(count, body);
+
+    else
+        body(0, count, 0);
+}
+
+// Simulation updating
+
+void BoidWorld::update()
+{
+    // Switch configurations before timing, as thread startup isn't part
+    // of the step
+    tuner.beforeStep(*this);
+
+    auto start = std::chrono::steady_clock::now();
+
+    // Buffers of the previous step are no longer referenced
+    scratch.reset();
+
+    // Pick which boids get simulated this step, and over how many steps
+    bool chunked = chunks.enabled;
+    if (chunked)
+        timeScales = scratch.allocate<float>(boids.size());
+
+    steppedBoids = chunked 
+        ? chunks.classify(boids, bounds, stepCount, timeScales) : boids.size();
+
+    // Move every boid due first, recording where it ended up for its trail
+    bool recordTrails = trails.getLength() != 0;
+    this->forEachRange(boids.size(), [this, recordTrails, chunked](size_t begin, size_t end, size_t)
+    {
+        for (size_t boidIter = begin; boidIter < end; ++boidIter)
+        {
+            float timeScale = chunked ? timeScales[boidIter] : 1;
+            if (timeScale != 0)
+            {
+                boids[boidIter].setTimeScale(timeScale);
+                boids[boidIter].updatePosition(*this);
+            }
+
+            if (recordTrails)
+                trails.record(boids.getId(boidIter), boids[boidIter].getPosition());
+        }
+    });
+
+    trails.advance();
+
+    // Bin boids into the heatmap, covering the world as it currently is
+    if (density.enabled)
+    {
+        if (density.getColumns() == 0 || density.getBounds() != bounds)
+            density.resize(bounds);
+
+        density.accumulate(boids);
+    }
+
+    // Bin boids for neighbor lookups by cell
+    if (this->usesGrid() || this->usesHashedGrid() || this->usesGridHierarchy() 
+        || this->usesPointTree())
+    {
+        std::span<sf::Vector2f> gridPositions = scratch.allocate<sf::Vector2f>(boids.size());
+        for (size_t boidIter = 0; boidIter < boids.size(); ++boidIter)
+            gridPositions[boidIter] = boids[boidIter].getPosition();
+
+        if (this->usesGrid())
+            grid.build(gridPositions, bounds, this->getGridCellSize());
+
+        if (this->usesHashedGrid())
+            hashedGrid.build(gridPositions, this->getGridCellSize());
+
+        // Levels span from the shortest sense radius to the longest
+        if (this->usesGridHierarchy())
+        {
+            float shortest = boids.size() ? boids[0].getSenseRadius(*this) : senseRadius;
+            float longest = shortest;
+            for (size_t boidIter = 1; boidIter < boids.size(); ++boidIter)
+            {
+                float radius = boids[boidIter].getSenseRadius(*this);
+                shortest = std::min(shortest, radius);
+                longest = std::max(longest, radius);
+            }
+
+            gridHierarchy.build(gridPositions, bounds, 
+                gridCellSize > 0 ? gridCellSize : std::max(shortest, 1.0f), longest);
+        }
+
+        if (this->usesPointTree())
+            pointTree.build(gridPositions);
+    }
+
+    // Let the steering pass unite neighbors on analyzed steps
+    bool analyze = analytics.isDue(stepCount);
+    ConcurrentUnionFind* flockUnion = analyze 
+        ? &analytics.begin(boids.size()) : nullptr;
+
+    // Coefficients and modes may be changed at any time, so pick the
+    // steering specialization matching them once per step
+    Boid::SteeringKernel steer = Boid::selectSteeringKernel(*this, analyze);
+    NeighborGather gather = Boid::selectNeighborGather(*this, analyze);
+
+    // Lazy steering aggregates the grid's cells up front
+    SteeringCache* cache = lazySteering && !analyze ? &steeringCache : nullptr;
+    if (cache)
+        cache->prepare(*this);
+
+    for (SteeringContext& context : contexts)
+    {
+        context.flockUnion = flockUnion;
+        context.gatherNeighbors = gather;
+        context.steeringCache = cache;
+        context.cacheHits = context.cacheMisses = 0;
+        context.steeredBoids = 0;
+
+        // Ordered gathers otherwise grow whenever a flock gets denser than
+        // any before it. Room for a thousand neighbors covers all but the
+        // most crowded flocks, and nobody has more neighbors than boids
+        if (gather)
+            context.ordered.reserve(std::min<size_t>(boids.size(), 1024));
+    }
+
+    // Flocks are only complete when every boid visits its neighbors. Fits
+    // follow wall-clock time, so deterministic worlds keep the phases set
+    if (stepBudget > 0 && !deterministic)
+        this->fitSteeringPhases();
+
+    size_t phases = analyze ? 1 : std::max<size_t>(steeringPhases, 1);
+    size_t phase = stepCount % phases;
+
+    // Boids skipping this step keep their pending turn, except on analyzed
+    // steps, where they still visit their neighbors
+    bool skipping = chunked && !analyze;
+
+    // Update the momentum of this step's share of boids, the rest being
+    // left to keep turning afterwards. Distant boids due this step always
+    // steer, as their chunk's turn could otherwise never line up with their
+    // phase. Steering only reads other boids, so ranges never step on each
+    // other
+    auto steerBoid = [this, steer, phases, phase, chunked, skipping](size_t boid_index, size_t worker)
+    {
+        float timeScale = chunked ? timeScales[boid_index] : 1;
+        if (timeScale == 0)
+        {
+            if (skipping)
+                return;
+
+            // Steered off its chunk's turn, so it turns over a single step
+            boids[boid_index].setTimeScale(1);
+        }
+
+        if (timeScale > 1 || boid_index % phases == phase)
+        {
+            (boids[boid_index].*steer)(*this, boid_index, contexts[worker]);
+            ++contexts[worker].steeredBoids;
+        }
+    };
+
+    // Regions are recut by the previous step's imbalance, so read it before
+    // the busy timers start over
+    bool decomposed = decomposition.enabled && this->usesGrid();
+    if (decomposed)
+        decomposition.prepare(grid, contexts.size(), stepCount, this->getSteerImbalance());
+
+    steerBusySeconds.assign(contexts.size(), 0);
+
+    auto steerStart = std::chrono::steady_clock::now();
+    if (decomposed)
+    {
+        // One region per worker, walked cell row by cell row, which are
+        // runs of the grid's sorted boids
+        this->forEachRange(contexts.size(), [this, &steerBoid](size_t begin, size_t end, size_t worker)
+        {
+            auto busyStart = std::chrono::steady_clock::now();
+            const std::vector<uint32_t>& indices = grid.getSortedIndices();
+
+            for (size_t region = begin; region < end; ++region)
+            {
+                const SpatialDecomposition::Region& area = decomposition.getRegions()[region];
+                if (area.lastColumn < area.firstColumn)
+                    continue;
+
+                for (size_t row = area.firstRow; row <= area.lastRow; ++row)
+                {
+                    size_t runBegin = grid.cellBegin(row * grid.getColumns() + area.firstColumn);
+                    size_t runEnd = grid.cellEnd(row * grid.getColumns() + area.lastColumn);
+
+                    for (size_t sorted = runBegin; sorted < runEnd; ++sorted)
+                        steerBoid(indices[sorted], worker);
+                }
+            }
+
+            auto busyEnd = std::chrono::steady_clock::now();
+            steerBusySeconds[worker] = std::chrono::duration<double>(busyEnd - busyStart).count();
+        });
+    }
+
+    else
+    {
+        this->forEachRange(boids.size(), [this, &steerBoid](size_t begin, size_t end, size_t worker)
+        {
+            auto busyStart = std::chrono::steady_clock::now();
+
+            for (size_t boidIter = begin; boidIter < end; ++boidIter)
+                steerBoid(boidIter, worker);
+
+            auto busyEnd = std::chrono::steady_clock::now();
+            steerBusySeconds[worker] = std::chrono::duration<double>(busyEnd - busyStart).count();
+        });
+    }
+    auto steerEnd = std::chrono::steady_clock::now();
+
+    // Boids off their phase keep turning as they already were, in a pass
+    // of their own so that only steering counts toward its measured cost.
+    // Phases only split non-analyzed steps, where boids not due are skipped
+    if (phases > 1)
+    {
+        this->forEachRange(boids.size(), [this, phases, phase, chunked](size_t begin, size_t end, size_t)
+        {
+            for (size_t boidIter = begin; boidIter < end; ++boidIter)
+            {
+                float timeScale = chunked ? timeScales[boidIter] : 1;
+                if (timeScale == 1 && boidIter % phases != phase)
+                    boids[boidIter].keepTurning(*this);
+            }
+        });
+    }
+
+    if (cache)
+    {
+        cache->hits = cache->misses = 0;
+        for (const SteeringContext& context : contexts)
+        {
+            cache->hits += context.cacheHits;
+            cache->misses += context.cacheMisses;
+        }
+    }
+
+    if (analyze)
+        analytics.finish(boids, stepCount);
+
+    ++stepCount;
+
+    if (history.enabled)
+        history.record(stepCount, boids);
+
+    if (trajectory.isOpen())
+        trajectory.record(stepCount, boids);
+
+    auto end = std::chrono::steady_clock::now();
+    lastStepSeconds = std::chrono::duration<double>(end - start).count();
+
+    // Track what steering costs apart from everything else, for fitting
+    // the budget. Analyzed steps cost more and would skew both
+    size_t steered = 0;
+    for (const SteeringContext& context : contexts)
+        steered += context.steeredBoids;
+
+    if (!analyze && steered != 0)
+    {
+        double steerSeconds = std::chrono::duration<double>(steerEnd - steerStart).count();
+        double perBoid = steerSeconds / steered;
+        double other = lastStepSeconds - steerSeconds;
+
+        bool first = steerSecondsPerBoid == 0;
+        steerSecondsPerBoid = first ? perBoid : steerSecondsPerBoid * 0.9 + perBoid * 0.1;
+        otherStepSeconds = first ? other : otherStepSeconds * 0.9 + other * 0.1;
+    }
+    analytics.recordStep(lastStepSeconds, analyze);
+    tuner.afterStep(*this, lastStepSeconds, analyze);
+}
+
+void BoidWorld::fitSteeringPhases()
+{
+    // Nothing measured yet
+    if (steerSecondsPerBoid == 0)
+        return;
+
+    // Split full steering over as many steps as it takes to fit whatever
+    // the rest of the step leaves of the budget
+    double available = stepBudget - otherStepSeconds;
+    double fullSteering = steerSecondsPerBoid * boids.size();
+    size_t phases = available <= 0 ? maxSteeringPhases
+        : static_cast<size_t>(std::ceil(fullSteering / available));
+
+    steeringPhases = std::clamp<size_t>(phases, 1, std::max<size_t>(maxSteeringPhases, 1));
+}
+
+bool BoidWorld::seekHistory(size_t step)
+{
+    std::vector<BoidStorage::BoidId> ids;
+    std::vector<sf::Vector2f> positions;
+    std::vector<float> headings;
+    if (!history.restore(step, ids, positions, headings))
+        return false;
+
+    if (boids.size() != ids.size())
+    {
+        boids.clear();
+        this->addBoids(ids.size());
+    }
+
+    for (size_t boidIter = 0; boidIter < boids.size(); ++boidIter)
+    {
+        boids[boidIter].restoreState(positions[boidIter], headings[boidIter]);
+        steeringCache.invalidate(boids.getId(boidIter));
+    }
+
+    stepCount = step;
+
+    // Trails start over where boids now are
+    this->setTrailLength(trails.getLength());
+    return true;
+}
+
+bool BoidWorld::usesGrid() const
+{
+    return neighborMode == NeighborMode::Sampled 
+        || (neighborMode == NeighborMode::Metric && spatialIndex == SpatialIndex::Grid) 
+        || lazySteering || decomposition.enabled || avoidanceC != 0;
+}
+
+bool BoidWorld::usesHashedGrid() const
+{
+    return neighborMode == NeighborMode::Metric 
+        && spatialIndex == SpatialIndex::HashedGrid;
+}
+
+bool BoidWorld::usesGridHierarchy() const
+{
+    return neighborMode == NeighborMode::Metric 
+        && spatialIndex == SpatialIndex::Hierarchical;
+}
+
+bool BoidWorld::usesPointTree() const
+{return neighborMode == NeighborMode::Topological;}
+
+double BoidWorld::getSteerImbalance() const
+{
+    double total = 0, busiest = 0;
+    for (double seconds : steerBusySeconds)
+    {
+        total += seconds;
+        busiest = std::max(busiest, seconds);
+    }
+
+    return total == 0 ? 1 : busiest * steerBusySeconds.size() / total;
+}
+
+float BoidWorld::getGridCellSize() const
+{
+    if (gridCellSize > 0)
+        return gridCellSize;
+
+    // Metric and sampled lookups then only scan the 3x3 cells around
+    // each boid
+    return std::max(senseRadius, 1.0f);
+}
+
+void BoidWorld::captureSnapshot(BoidSnapshot& snapshot) const
+{
+    snapshot.step = stepCount;
+    snapshot.stepSeconds = lastStepSeconds;
+    snapshot.bounds = bounds;
+
+    size_t boidCount = boids.size();
+    snapshot.positions.resize(boidCount);
+    snapshot.rotations.resize(boidCount);
+    for (size_t boidIter = 0; boidIter < boidCount; ++boidIter)
+    {
+        snapshot.positions[boidIter] = boids[boidIter].getPosition();
+        snapshot.rotations[boidIter] = boids[boidIter].getRotation();
+    }
+
+    snapshot.trailLength = trails.getLength();
+    trails.copyOrdered(boids, snapshot.trails);
+    snapshot.trailHistoryBytes = trails.getMemoryBytes();
+
+    // The field is small, so copying it whole is cheap
+    if (density.enabled)
+        snapshot.density = density;
+    else
+        snapshot.density.enabled = false;
+
+    snapshot.analyzedStep = analytics.analyzedStep;
+    snapshot.flockCount = analytics.flockCount;
+    snapshot.largestFlock = analytics.largestFlock;
+    snapshot.polarization = analytics.polarization;
+    snapshot.analyticsOverhead = analytics.overheadFraction;
+
+    snapshot.steerImbalance = this->getSteerImbalance();
+    snapshot.decomposed = decomposition.enabled;
+    snapshot.steeringPhases = steeringPhases;
+    snapshot.chunked = chunks.enabled;
+    snapshot.steppedBoids = steppedBoids;
+    snapshot.nearChunks = chunks.getNearChunks();
+    snapshot.totalChunks = chunks.getTotalChunks();
+    snapshot.recordingHistory = history.enabled;
+    snapshot.historyFirstStep = history.getFirstStep();
+    snapshot.historyLastStep = history.getLastStep();
+    snapshot.historyBytes = history.getMemoryBytes();
+    snapshot.recordingTrajectory = trajectory.isOpen();
+    snapshot.trajectoryBytes = trajectory.getWrittenBytes();
+    snapshot.lazySteering = lazySteering;
+    snapshot.steeringHits = steeringCache.hits;
+    snapshot.steeringMisses = steeringCache.misses;
+}
+
+// Metrics
+
+float BoidWorld::getPolarization() const
+{
+    size_t boidCount = boids.size();
+    if (boidCount == 0)
+        return 0;
+
+    // Add up every heading as a unit vector
+    sf::Vector2f headingSum(0, 0);
+    for (size_t boidIter = 0; boidIter < boidCount; ++boidIter)
+    {
+        float direction = QuickMath::degreesToRadians
+            (boids[boidIter].getRotation());
+        headingSum += sf::Vector2f(std::cos(direction), std::sin(direction));
+    }
+
+    return QuickMath::getMagnitude(headingSum) / boidCount;
+}
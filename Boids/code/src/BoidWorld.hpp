@@ -0,0 +1,292 @@
+#ifndef BOID_WORLD_HPP
+#define BOID_WORLD_HPP
+
+// For simulation bounds
+#include <SFML/Graphics.hpp>
+
+// For Boids
+#include "BoidStorage.hpp"
+
+// For flock structure measurements
+#include "FlockAnalytics.hpp"
+
+// For handing steps over to rendering
+#include "BoidSnapshot.hpp"
+
+// For position histories
+#include "TrailHistory.hpp"
+
+// For neighbor lookups by cell
+#include "UniformGrid.hpp"
+#include "HashedGrid.hpp"
+#include "GridHierarchy.hpp"
+#include "PointQuadtree.hpp"
+
+// For neighbor modes
+#include "SteeringPolicy.hpp"
+
+// For lazy steering
+#include "SteeringCache.hpp"
+
+// For simulating distant regions at a reduced rate
+#include "WorldChunks.hpp"
+
+// For going back in time
+#include "WorldHistory.hpp"
+
+// For recording trajectories to disk
+#include "TrajectoryWriter.hpp"
+
+// For splitting steering by region
+#include "SpatialDecomposition.hpp"
+
+// For picking the fastest configuration
+#include "AutoTuner.hpp"
+
+// For stepping on several threads
+#include "ThreadPool.hpp"
+
+// For per-step buffers
+#include "ScratchArena.hpp"
+
+// For the owned pool
+#include <memory>
+
+
+// Self-contained flock simulation. Unlike BoidManager, any number of worlds
+// may live side by side, each with its own parameters and seed
+class BoidWorld
+{
+    public:
+        // Simulation parameters
+        sf::FloatRect bounds;
+        float turnSpeed;
+        float flySpeed;
+        // How far boids see, unless they have a radius of their own
+        float senseRadius;
+
+        float separationC;
+        float allignmentC;
+        float cohesionC;
+
+        // Predictive avoidance. Every boid looks lookAheadSteps ahead along
+        // its heading and steers aside from the earliest boid it would come
+        // within collisionDistance of, harder the sooner. A zero avoidanceC
+        // disables it, and it adds to the other rules, so it needs one of
+        // them in effect
+        float avoidanceC;
+        float lookAheadSteps;
+        float collisionDistance;
+
+        // Which boids each one steers by
+        NeighborMode neighborMode;
+
+        // How metric neighborhoods are looked up
+        SpatialIndex spatialIndex;
+
+        // Visit neighbors by increasing index through a single steering
+        // kernel whatever the spatial index and cell size, so a seed always
+        // yields bit-identical steps. Every pass already works per boid,
+        // and reductions over boids run in index order, so the thread count
+        // never changes results either
+        bool deterministic;
+
+        // Reuse each boid's latest desired direction while the grid cells
+        // around it barely change, instead of scanning its neighbors.
+        // Analyzed steps always scan
+        bool lazySteering;
+
+        // Most candidates examined per boid in sampled mode
+        size_t sampleCount;
+
+        // Steer only one in this many boids per step, round-robin, while
+        // the rest keep turning toward their latest desired direction.
+        // One steers every boid every step, as do analyzed steps
+        size_t steeringPhases;
+
+        // Target step duration in seconds. When non-zero, steeringPhases is
+        // picked every step to fit it, up to maxSteeringPhases. Fits follow
+        // measured time, so deterministic worlds ignore the budget
+        double stepBudget;
+        size_t maxSteeringPhases;
+
+        // Amount of nearest boids steered by in topological mode
+        size_t topologicalCount;
+
+        // Cell size of the neighbor grid. Zero picks senseRadius
+        float gridCellSize;
+
+        // Whether boids leaving the bounds come back in on the other side.
+        // Otherwise they fly on forever, and bounds only matter for
+        // spawning and for the dense grid, so the hashed one suits better
+        bool wrapAround;
+
+        // Seed for the boids' starting positions and rotations. The n-th
+        // boid spawned under a seed always starts out the same
+        uint32_t seed;
+
+        // Boid collection
+        BoidStorage boids;
+
+        // Steps simulated since the boids were created
+        size_t stepCount;
+
+        // Duration of the latest step
+        double lastStepSeconds;
+
+        // Boids moved during the latest step
+        size_t steppedBoids;
+
+        // Time each worker spent steering during the latest step
+        std::vector<double> steerBusySeconds;
+
+        // Flock structure, gathered every analytics.interval steps
+        FlockAnalytics analytics;
+
+        // Recent positions of every boid, recorded once per step
+        TrailHistory trails;
+
+        // Decaying density and heading heatmap, when enabled
+        DensityField density;
+
+        // Boids binned by cell after the latest position pass, only built
+        // when neighbors are looked up or collisions predicted through it
+        UniformGrid grid;
+
+        // Desired directions reused by lazy steering, and how often they
+        // were
+        SteeringCache steeringCache;
+
+        // Regions of the grid steered by each worker, when enabled instead
+        // of index ranges
+        SpatialDecomposition decomposition;
+
+        // Level of detail by region, when enabled
+        WorldChunks chunks;
+
+        // Boids binned by hashed cell after the latest position pass, only
+        // built for the hashed spatial index
+        HashedGrid hashedGrid;
+
+        // Boids binned at every level after the latest position pass, only
+        // built for the hierarchical spatial index. The finest cells are
+        // gridCellSize wide if set, or as wide as the shortest sense radius
+        GridHierarchy gridHierarchy;
+
+        // Boids sorted into a quadtree after the latest position pass, only
+        // built for topological neighborhoods
+        PointQuadtree pointTree;
+
+        // Past states of every boid, recorded after every step when enabled
+        WorldHistory history;
+
+        // Position of every boid after every step, written to disk while
+        // a file is open
+        TrajectoryWriter trajectory;
+
+        // Picks the spatial index, grid cell size and thread count, when
+        // enabled
+        AutoTuner tuner;
+
+        // Default-construct an empty world
+        BoidWorld();
+
+        // Forbid any copy-construction or copy-assignment
+        BoidWorld(BoidWorld const&) = delete;
+        BoidWorld& operator=(BoidWorld const&) = delete;
+
+        // Destroy the world and its boids
+        virtual ~BoidWorld();
+
+        // Set the screen bounds for boids
+        bool setBounds(const sf::FloatRect& screen_bounds);
+
+        // Discard every boid and start over with the given amount, placed
+        // from the seed
+        bool setBoidCount(const size_t boid_count);
+
+        // Spawn boids at random positions and rotations, optionally getting
+        // their ids. Existing boids are left untouched, and new ones are
+        // placed in parallel
+        virtual void addBoids(const size_t boid_count,
+            std::vector<BoidStorage::BoidId>* added_ids = nullptr);
+
+        // Despawn the given boids, moving others into their place. Get the
+        // amount that were actually alive
+        size_t removeBoids(const std::vector<BoidStorage::BoidId>& boid_ids);
+
+        // Set the amount of positions kept per boid trail, starting them
+        // all over at the current positions. Zero disables trails
+        void setTrailLength(size_t trail_length);
+
+        // Set the amount of threads each step is split across. Zero means
+        // one per hardware thread, one keeps stepping on the caller's thread
+        void setThreadCount(size_t thread_count);
+
+        // Get the amount of threads each step is split across
+        size_t getThreadCount() const;
+
+        // Update the simulation
+        void update();
+
+        // Put every boid back where it was after a recorded step, and carry
+        // on from there. As many boids as back then are brought back, but
+        // their ids only match if none were spawned or despawned since.
+        // False if the step isn't in the history
+        bool seekHistory(size_t step);
+
+        // Get the ratio of the busiest worker's steering time to the average
+        // one, during the latest step
+        double getSteerImbalance() const;
+
+        // Copy the state needed for drawing the latest step
+        void captureSnapshot(BoidSnapshot& snapshot) const;
+
+        // Get the order parameter of the flock: the length of the average
+        // heading, 1 when every boid flies the same way and near 0 when
+        // headings are random
+        float getPolarization() const;
+
+    private:
+        // Boids spawned since the seed was last applied, which numbers the
+        // random draws of the next one
+        uint64_t spawnCount;
+
+        // Buffers only needed through a step, all handed back at the start
+        // of the next one
+        ScratchArena scratch;
+
+        // Steps each boid covers this step, zero for those skipping it,
+        // when chunks are enabled. Lives in the scratch arena
+        std::span<float> timeScales;
+
+        // Moving averages of the steering pass cost per steered boid, and
+        // of the rest of a step, for fitting the step budget
+        double steerSecondsPerBoid;
+        double otherStepSeconds;
+
+        // Workers for the parallel passes, absent when single-threaded
+        std::unique_ptr<ThreadPool> pool;
+
+        // Per-worker steering state
+        std::vector<SteeringContext> contexts;
+
+        // Check whether the grid gets built, for neighbors or collision
+        // rays, or the hashed one, the hierarchy or the point tree
+        bool usesGrid() const;
+        bool usesHashedGrid() const;
+        bool usesGridHierarchy() const;
+        bool usesPointTree() const;
+
+        // Pick the amount of steering phases fitting the step budget
+        void fitSteeringPhases();
+
+        // Get the cell size to build the grid with
+        float getGridCellSize() const;
+
+        // Run a body over contiguous ranges of [0, count) as (begin, end,
+        // worker), on the pool when there's one
+        void forEachRange(size_t count, ThreadPool::RangeFunction body);
+};
+
+#endif
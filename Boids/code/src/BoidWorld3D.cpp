@@ -0,0 +1,258 @@
+#include "BoidWorld3D.hpp"
+
+// For vector math
+#include "QuickMath.hpp"
+
+// For seeded placement
+#include "Random.hpp"
+
+// For timing steps
+#include <chrono>
+
+// For clamping cosines
+#include <algorithm>
+
+// Constructor
+
+BoidWorld3D::BoidWorld3D() :
+boundsCorner(0, 0, 0), boundsSize(1, 1, 1),
+turnSpeed(90), flySpeed(1), senseRadius(1),
+separationC(1), allignmentC(1), cohesionC(1),
+spatialIndex(SpatialIndex::Grid), seed(0), stepCount(0), lastStepSeconds(0)
+{}
+
+// Setters
+
+bool BoidWorld3D::setBounds(const sf::Vector3f& corner, const sf::Vector3f& size)
+{
+    if (size.x <= 0 || size.y <= 0 || size.z <= 0)
+        return false;
+
+    this->boundsCorner = corner;
+    this->boundsSize = size;
+    return true;
+}
+
+bool BoidWorld3D::setBoidCount(const size_t boid_count)
+{
+    if (boid_count == 0)
+        return false;
+
+    this->boids.resize(boid_count);
+    this->stepCount = 0;
+
+    // Spread boids uniformly over the box, heading uniformly over the
+    // sphere. Draws only depend on the seed and each boid's index
+    this->forEachRange(boid_count, [&](size_t begin, size_t end, size_t)
+    {
+        for (size_t boidIter = begin; boidIter < end; ++boidIter)
+        {
+            uint64_t planeBits = Random::philox(boidIter * 3, this->seed);
+            uint64_t depthBits = Random::philox(boidIter * 3 + 1, this->seed);
+            uint64_t angleBits = Random::philox(boidIter * 3 + 2, this->seed);
+
+            Boid3D& boid = this->boids[boidIter];
+            boid.position = this->boundsCorner + sf::Vector3f
+                (Random::uniform(planeBits, 0, this->boundsSize.x),
+                Random::uniform(planeBits >> 32, 0, this->boundsSize.y),
+                Random::uniform(depthBits, 0, this->boundsSize.z));
+
+            float z = Random::uniform(depthBits >> 32, -1, 1);
+            float angle = Random::uniform(angleBits, 0, 2 * std::numbers::pi);
+            float planar = std::sqrt(1 - z * z);
+            boid.heading = sf::Vector3f(planar * std::cos(angle), planar * std::sin(angle), z);
+        }
+    });
+
+    return true;
+}
+
+// Threading
+
+void BoidWorld3D::setThreadCount(size_t thread_count)
+{
+    this->pool.reset();
+    if (thread_count != 1)
+        this->pool.reset(new ThreadPool(thread_count));
+}
+
+size_t BoidWorld3D::getThreadCount() const
+{return this->pool ? this->pool->getThreadCount() : 1;}
+
+void BoidWorld3D::forEachRange(size_t count, ThreadPool::RangeFunction body)
+{
+    if (this->pool)
+        this->pool->parallelFor(count, body);
+
+    else
+        body(0, count, 0);
+}
+
+// Simulation updating
+
+void BoidWorld3D::update()
+{
+    auto start = std::chrono::steady_clock::now();
+    size_t boidCount = this->boids.size();
+
+    // Buffers of the previous step are no longer referenced
+    this->scratch.reset();
+
+    // Move every boid along its heading, wrapping around the box
+    this->forEachRange(boidCount, [&](size_t begin, size_t end, size_t)
+    {
+        for (size_t boidIter = begin; boidIter < end; ++boidIter)
+        {
+            sf::Vector3f& position = this->boids[boidIter].position;
+            position += this->boids[boidIter].heading * this->flySpeed;
+
+            float* coordinates[] = {&position.x, &position.y, &position.z};
+            const float corners[] = {boundsCorner.x, boundsCorner.y, boundsCorner.z};
+            const float sizes[] = {boundsSize.x, boundsSize.y, boundsSize.z};
+            for (size_t axis = 0; axis < 3; ++axis)
+            {
+                if (*coordinates[axis] < corners[axis])
+                    *coordinates[axis] += sizes[axis];
+                else if (*coordinates[axis] >= corners[axis] + sizes[axis])
+                    *coordinates[axis] -= sizes[axis];
+            }
+        }
+    });
+
+    // Bin boids for neighbor lookups by cell
+    bool useGrid = this->spatialIndex != SpatialIndex::BruteForce && boidCount != 0;
+    if (useGrid)
+    {
+        std::span<sf::Vector3f> gridPositions = this->scratch.allocate<sf::Vector3f>(boidCount);
+        for (size_t boidIter = 0; boidIter < boidCount; ++boidIter)
+            gridPositions[boidIter] = this->boids[boidIter].position;
+
+        // Cells narrower than senseRadius would only add cells to check,
+        // and sparse boxes would need more cells than there are boids
+        float volume = this->boundsSize.x * this->boundsSize.y * this->boundsSize.z;
+        float cellSize = std::max(this->senseRadius, std::cbrt(volume / boidCount));
+
+        this->grid.build(gridPositions, this->boundsCorner, this->boundsSize, cellSize);
+    }
+
+    // Steer every boid off the same positions, then turn them all at once
+    this->nextHeadings = this->scratch.allocate<sf::Vector3f>(boidCount);
+    this->forEachRange(boidCount, [&](size_t begin, size_t end, size_t)
+    {
+        if (useGrid)
+            this->steerRange<true>(begin, end);
+        else
+            this->steerRange<false>(begin, end);
+    });
+
+    for (size_t boidIter = 0; boidIter < boidCount; ++boidIter)
+        this->boids[boidIter].heading = this->nextHeadings[boidIter];
+
+    ++this->stepCount;
+
+    auto end = std::chrono::steady_clock::now();
+    this->lastStepSeconds = std::chrono::duration<double>(end - start).count();
+}
+
+template <bool UseGrid>
+void BoidWorld3D::steerRange(size_t begin, size_t end)
+{
+    const float squaredRadius = this->senseRadius * this->senseRadius;
+    const std::vector<uint32_t>& indices = this->grid.getSortedIndices();
+    const std::vector<sf::Vector3f>& points = this->grid.getSortedPoints();
+
+    for (size_t boidIter = begin; boidIter < end; ++boidIter)
+    {
+        const Boid3D& boid = this->boids[boidIter];
+
+        // Keep track of the driving forces, and of the neighbors' summed
+        // positions and headings
+        sf::Vector3f separationF, headingSum, positionSum;
+        size_t consideredNeighbors = 0;
+
+        auto visit = [&](size_t neighbor_index, const sf::Vector3f& neighbor_pos)
+        {
+            if (neighbor_index == boidIter)
+                return;
+
+            sf::Vector3f offset = boid.position - neighbor_pos;
+            float squaredDist = QuickMath::dotProduct(offset, offset);
+            if (squaredDist > squaredRadius || squaredDist == 0)
+                return;
+
+            ++consideredNeighbors;
+
+            // Separation is inversely proportional to the distance
+            separationF += offset / std::sqrt(squaredDist);
+            headingSum += this->boids[neighbor_index].heading;
+            positionSum += neighbor_pos;
+        };
+
+        if constexpr (UseGrid)
+        {
+            sf::Vector3f reach(this->senseRadius, this->senseRadius, this->senseRadius);
+            this->grid.forEachRowRun(boid.position - reach, boid.position + reach, 
+                [&](size_t first, size_t last)
+            {
+                size_t runBegin = this->grid.cellBegin(first), runEnd = this->grid.cellEnd(last);
+                for (size_t sorted = runBegin; sorted < runEnd; ++sorted)
+                    visit(indices[sorted], points[sorted]);
+            });
+        }
+
+        else
+            for (size_t neighborIter = 0; neighborIter < this->boids.size(); ++neighborIter)
+                visit(neighborIter, this->boids[neighborIter].position);
+
+        if (consideredNeighbors == 0)
+        {
+            this->nextHeadings[boidIter] = boid.heading;
+            continue;
+        }
+
+        // Add the forces of every rule up into a desired direction
+        sf::Vector3f averagePos = positionSum / static_cast<float>(consideredNeighbors);
+        sf::Vector3f desired = QuickMath::getNormalized(separationF) * this->separationC
+            + QuickMath::getNormalized(headingSum) * this->allignmentC
+            + QuickMath::getNormalized(averagePos - boid.position) * this->cohesionC;
+
+        this->nextHeadings[boidIter] = this->turnTowards(boid.heading, desired);
+    }
+}
+
+sf::Vector3f BoidWorld3D::turnTowards(const sf::Vector3f& heading, const sf::Vector3f& desired) const
+{
+    sf::Vector3f direction = QuickMath::getNormalized(desired);
+    if (direction == sf::Vector3f())
+        return heading;
+
+    // Close enough to turn all the way
+    float cosine = std::clamp(QuickMath::dotProduct(heading, direction), -1.f, 1.f);
+    float maxAngle = this->turnSpeed * std::numbers::pi / 180.0;
+    if (std::acos(cosine) <= maxAngle)
+        return direction;
+
+    // Otherwise rotate within the plane of both, toward the desired one.
+    // Opposite directions span no plane, so any perpendicular will do
+    sf::Vector3f perpendicular = direction - heading * cosine;
+    if (QuickMath::getMagnitude(perpendicular) < 1e-6)
+        perpendicular = QuickMath::crossProduct(heading, std::abs(heading.x) < 0.9f
+            ? sf::Vector3f(1, 0, 0) : sf::Vector3f(0, 1, 0));
+
+    perpendicular = QuickMath::getNormalized(perpendicular);
+    return QuickMath::getNormalized(heading * std::cos(maxAngle) + perpendicular * std::sin(maxAngle));
+}
+
+// Measurements
+
+float BoidWorld3D::getPolarization() const
+{
+    if (this->boids.empty())
+        return 0;
+
+    sf::Vector3f headingSum;
+    for (const Boid3D& boid : this->boids)
+        headingSum += boid.heading;
+
+    return QuickMath::getMagnitude(headingSum) / this->boids.size();
+}
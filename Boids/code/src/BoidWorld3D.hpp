@@ -0,0 +1,116 @@
+#ifndef BOID_WORLD_3D_HPP
+#define BOID_WORLD_3D_HPP
+
+// For positions and headings
+#include <SFML/Graphics.hpp>
+
+// For the worker pool
+#include <memory>
+
+// For neighbor lookups by cell
+#include "UniformGrid3D.hpp"
+
+// For the spatial index
+#include "SteeringPolicy.hpp"
+
+// For stepping on several threads
+#include "ThreadPool.hpp"
+
+// For per-step buffers
+#include "ScratchArena.hpp"
+
+// A boid flying through a volume, heading along a unit vector
+struct Boid3D
+{
+    sf::Vector3f position;
+    sf::Vector3f heading;
+};
+
+// Volumetric counterpart of BoidWorld. Boids follow the same separation,
+// allignment and cohesion rules within a box they wrap around in, with
+// headings as unit vectors instead of angles, and neighbors looked up
+// through a 3D grid of senseRadius wide cells or by brute force
+class BoidWorld3D
+{
+    public:
+        // Simulation parameters, as in BoidWorld. turnSpeed is the largest
+        // angle a heading turns by per step, in degrees
+        sf::Vector3f boundsCorner;
+        sf::Vector3f boundsSize;
+        float turnSpeed;
+        float flySpeed;
+        float senseRadius;
+        float separationC;
+        float allignmentC;
+        float cohesionC;
+
+        // How neighbors are found. The hashed grid and the hierarchy aren't
+        // available in 3D, and fall back onto the regular grid
+        SpatialIndex spatialIndex;
+
+        // Seed for the boids' starting positions and headings
+        uint32_t seed;
+
+        // Boid collection
+        std::vector<Boid3D> boids;
+
+        // Steps simulated since the boids were created
+        size_t stepCount;
+
+        // Duration of the latest step
+        double lastStepSeconds;
+
+        // Boids binned by cell after the latest position pass, only built
+        // when neighbors are looked up through it
+        UniformGrid3D grid;
+
+        // Default-construct an empty world in a unit box
+        BoidWorld3D();
+
+        // Forbid any copy-construction or copy-assignment
+        BoidWorld3D(BoidWorld3D const&) = delete;
+        BoidWorld3D& operator=(BoidWorld3D const&) = delete;
+
+        // Set the box boids live in
+        bool setBounds(const sf::Vector3f& corner, const sf::Vector3f& size);
+
+        // Discard every boid and start over with the given amount, placed
+        // from the seed
+        bool setBoidCount(const size_t boid_count);
+
+        // Set the amount of threads each step is split across. Zero means
+        // one per hardware thread, one keeps stepping on the caller's thread
+        void setThreadCount(size_t thread_count);
+
+        // Get the amount of threads each step is split across
+        size_t getThreadCount() const;
+
+        // Update the simulation
+        void update();
+
+        // Get the order parameter of the flock, as in BoidWorld
+        float getPolarization() const;
+
+    private:
+        // Workers for the parallel passes, absent when single-threaded
+        std::unique_ptr<ThreadPool> pool;
+
+        // Buffers only needed through a step, all handed back at the start
+        // of the next one
+        ScratchArena scratch;
+
+        // Headings steered toward this step, in the scratch arena
+        std::span<sf::Vector3f> nextHeadings;
+
+        // Run a body over [0, count) split into ranges, one per worker
+        void forEachRange(size_t count, ThreadPool::RangeFunction body);
+
+        // Steer boids in [begin, end) by the neighbors a source yields
+        template <bool UseGrid>
+        void steerRange(size_t begin, size_t end);
+
+        // Get a heading turned toward a direction by at most turnSpeed
+        sf::Vector3f turnTowards(const sf::Vector3f& heading, const sf::Vector3f& desired) const;
+};
+
+#endif
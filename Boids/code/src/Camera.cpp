@@ -0,0 +1,99 @@
+#include "Camera.hpp"
+
+// For clamping zoom
+#include <algorithm>
+
+// Constructor
+
+Camera::Camera(const sf::FloatRect& world_area) :
+minZoom(0.05), maxZoom(4), keyPanStep(0.1),
+view(world_area), initialSize(world_area.width, world_area.height),
+zoom(1), dragging(false)
+{}
+
+// Input
+
+bool Camera::handleEvent(const sf::Event& event, const sf::RenderWindow& window)
+{
+    switch (event.type)
+    {
+        case sf::Event::MouseWheelScrolled:
+        {
+            float factor = event.mouseWheelScroll.delta > 0 ? 1 / 1.2f : 1.2f;
+            this->zoomAt(factor, sf::Vector2i
+                (event.mouseWheelScroll.x, event.mouseWheelScroll.y), window);
+            return true;
+        }
+
+        case sf::Event::MouseButtonPressed:
+            if (event.mouseButton.button != sf::Mouse::Left)
+                return false;
+
+            this->dragging = true;
+            this->dragOrigin = sf::Vector2i(event.mouseButton.x, event.mouseButton.y);
+            return true;
+
+        case sf::Event::MouseButtonReleased:
+            if (event.mouseButton.button != sf::Mouse::Left)
+                return false;
+
+            this->dragging = false;
+            return true;
+
+        case sf::Event::MouseMoved:
+        {
+            if (!this->dragging)
+                return false;
+
+            // Move the view opposite to the cursor, so the world follows it
+            sf::Vector2i cursor(event.mouseMove.x, event.mouseMove.y);
+            this->view.move(window.mapPixelToCoords(this->dragOrigin, this->view)
+                - window.mapPixelToCoords(cursor, this->view));
+
+            this->dragOrigin = cursor;
+            return true;
+        }
+
+        case sf::Event::KeyPressed:
+        {
+            sf::Vector2f step = this->view.getSize() * this->keyPanStep;
+            switch (event.key.code)
+            {
+                case sf::Keyboard::Left: this->view.move(-step.x, 0); return true;
+                case sf::Keyboard::Right: this->view.move(step.x, 0); return true;
+                case sf::Keyboard::Up: this->view.move(0, -step.y); return true;
+                case sf::Keyboard::Down: this->view.move(0, step.y); return true;
+                default: return false;
+            }
+        }
+
+        default:
+            return false;
+    }
+}
+
+void Camera::zoomAt(float factor, const sf::Vector2i& pixel, 
+    const sf::RenderWindow& window)
+{
+    this->zoom = std::clamp(this->zoom * factor, this->minZoom, this->maxZoom);
+
+    // Keep the world point under the cursor where it was
+    sf::Vector2f before = window.mapPixelToCoords(pixel, this->view);
+    this->view.setSize(this->initialSize * this->zoom);
+    sf::Vector2f after = window.mapPixelToCoords(pixel, this->view);
+
+    this->view.move(before - after);
+}
+
+// Getters
+
+const sf::View& Camera::getView() const
+{return this->view;}
+
+sf::FloatRect Camera::getViewRect() const
+{
+    sf::Vector2f size = this->view.getSize();
+    sf::Vector2f center = this->view.getCenter();
+
+    return sf::FloatRect(center - size / 2.f, size);
+}
@@ -0,0 +1,45 @@
+#ifndef CAMERA_HPP
+#define CAMERA_HPP
+
+// For views and input
+#include <SFML/Graphics.hpp>
+
+// Zoomable, pannable view over the world. The mouse wheel zooms around the
+// cursor, dragging with the left button or the arrow keys pan
+class Camera
+{
+    public:
+        // Zoom limits, as view size over the initial view size
+        float minZoom;
+        float maxZoom;
+
+        // Distance panned per arrow key press, as a fraction of the view size
+        float keyPanStep;
+
+        // Start by showing the given world area
+        explicit Camera(const sf::FloatRect& world_area);
+
+        // React to zoom and pan input. True if the event was used
+        bool handleEvent(const sf::Event& event, const sf::RenderWindow& window);
+
+        // Get the view to render with
+        const sf::View& getView() const;
+
+        // Get the world area currently in view
+        sf::FloatRect getViewRect() const;
+
+    private:
+        sf::View view;
+        sf::Vector2f initialSize;
+        float zoom;
+
+        // Last cursor position while dragging
+        bool dragging;
+        sf::Vector2i dragOrigin;
+
+        // Scale the view around a fixed window pixel
+        void zoomAt(float factor, const sf::Vector2i& pixel, 
+            const sf::RenderWindow& window);
+};
+
+#endif
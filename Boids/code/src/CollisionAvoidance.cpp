@@ -0,0 +1,131 @@
+#include "CollisionAvoidance.hpp"
+
+// For the grid, boids and parameters
+#include "BoidWorld.hpp"
+
+// For headings and normalizing
+#include "QuickMath.hpp"
+
+// For clamping onto the ray
+#include <algorithm>
+
+// For roots and infinities
+#include <cmath>
+#include <limits>
+
+// Get the unit vector a boid flies along
+static sf::Vector2f headingOf(const Boid& boid)
+{
+    float radians = QuickMath::degreesToRadians(boid.getRotation());
+    return sf::Vector2f(std::cos(radians), std::sin(radians));
+}
+
+// Prediction
+
+bool CollisionAvoidance::steerAway(const BoidWorld& world, size_t boid_index,
+    sf::Vector2f& avoidance_force)
+{
+    const UniformGrid& grid = world.grid;
+    const sf::FloatRect& area = grid.getArea();
+    const std::vector<uint32_t>& indices = grid.getSortedIndices();
+    const std::vector<sf::Vector2f>& points = grid.getSortedPoints();
+
+    const sf::Vector2f position = world.boids[boid_index].getPosition();
+    const sf::Vector2f heading = headingOf(world.boids[boid_index]);
+    const sf::Vector2f velocity = heading * world.flySpeed;
+
+    const float horizon = world.lookAheadSteps;
+    const float reach = world.flySpeed * horizon;
+    const float margin = world.collisionDistance;
+    const float squaredContact = margin * margin;
+
+    // Earliest collision so far, ties going to the lowest index so that
+    // the scan order never matters
+    float earliest = std::numeric_limits<float>::infinity();
+    size_t earliestIndex = SIZE_MAX;
+    sf::Vector2f contactOffset;
+
+    grid.forEachCellAlongRay(position, heading, reach,
+        [&](size_t, size_t, float enter, float exit)
+    {
+        // Boids within margin of the part of the ray in this cell may sit
+        // in the cells next to it
+        sf::Vector2f from = position + heading * enter;
+        sf::Vector2f to = position + heading * exit;
+
+        const sf::Vector2f lowest(std::min(from.x, to.x), std::min(from.y, to.y));
+        const sf::Vector2f highest(std::max(from.x, to.x), std::max(from.y, to.y));
+        const sf::Vector2f widening(margin, margin);
+
+        grid.forEachRowRun(lowest - widening, highest + widening, [&](size_t first, size_t last)
+        {
+            size_t begin = grid.cellBegin(first), end = grid.cellEnd(last);
+            for (size_t sorted = begin; sorted < end; ++sorted)
+            {
+                size_t other = indices[sorted];
+                if (other == boid_index)
+                    continue;
+
+                // Only boids within margin of the ray within the grid,
+                // whatever the cells happen to hold around it
+                sf::Vector2f offset = points[sorted] - position;
+                float along = std::clamp(offset.x * heading.x + offset.y * heading.y, 0.f, reach);
+                sf::Vector2f closest = position + heading * along;
+                sf::Vector2f gap = offset - heading * along;
+
+                if (gap.x * gap.x + gap.y * gap.y > squaredContact
+                    || closest.x < area.left || closest.x > area.left + area.width
+                    || closest.y < area.top || closest.y > area.top + area.height)
+                    continue;
+
+                sf::Vector2f relative = headingOf(world.boids[other]) * world.flySpeed - velocity;
+
+                float time = timeToContact(offset, relative, squaredContact);
+                if (time > horizon || time > earliest 
+                    || (time == earliest && other > earliestIndex))
+                    continue;
+
+                earliest = time;
+                earliestIndex = other;
+                contactOffset = offset + relative * time;
+            }
+        });
+    });
+
+    if (earliestIndex == SIZE_MAX)
+        return false;
+
+    // Veer sideways, away from where the other boid will be. Braking isn't
+    // an option, and heading straight back would only meet whoever follows
+    sf::Vector2f away = -contactOffset;
+    away -= heading * (away.x * heading.x + away.y * heading.y);
+    if (away.x * away.x + away.y * away.y < 1e-6f)
+        away = sf::Vector2f(-heading.y, heading.x);
+
+    float urgency = horizon > 0 ? 1 - earliest / horizon : 1;
+    avoidance_force = QuickMath::getNormalized(away) * (world.avoidanceC * urgency);
+    return true;
+}
+
+float CollisionAvoidance::timeToContact(const sf::Vector2f& offset,
+    const sf::Vector2f& relative, float squared_distance)
+{
+    // Solve |offset + relative * time|² = squared_distance for the
+    // earliest time
+    float c = offset.x * offset.x + offset.y * offset.y - squared_distance;
+    if (c <= 0)
+        return 0;
+
+    float a = relative.x * relative.x + relative.y * relative.y;
+    float b = offset.x * relative.x + offset.y * relative.y;
+
+    // Drifting apart, or not moving relative to each other
+    if (b >= 0 || a == 0)
+        return std::numeric_limits<float>::infinity();
+
+    float discriminant = b * b - a * c;
+    if (discriminant < 0)
+        return std::numeric_limits<float>::infinity();
+
+    return (-b - std::sqrt(discriminant)) / a;
+}
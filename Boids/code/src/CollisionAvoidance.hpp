@@ -0,0 +1,33 @@
+#ifndef COLLISION_AVOIDANCE_HPP
+#define COLLISION_AVOIDANCE_HPP
+
+// For forces
+#include <SFML/Graphics.hpp>
+
+// Forward declaration, only handled through references
+class BoidWorld;
+
+// Time-to-collision avoidance. A boid casts a ray lookAheadSteps of flight
+// long along its heading through the world's grid, visiting only the cells
+// the ray crosses, and checks the boids within collisionDistance of the
+// part of it within the grid, which doesn't depend on the cell size.
+// Both keep flying straight at their current headings, and the earliest
+// time they'd come within collisionDistance of each other is the one
+// steered away from. Boids closing in from the side are left to their own
+// rays, which cross this boid's position
+struct CollisionAvoidance
+{
+    // Get the force steering a boid aside from its earliest predicted
+    // collision, scaled by avoidanceC and by how soon it comes. False if
+    // none is predicted within lookAheadSteps
+    static bool steerAway(const BoidWorld& world, size_t boid_index,
+        sf::Vector2f& avoidance_force);
+
+    // Get the earliest time two bodies moving apart by offset + relative *
+    // time come within the given squared distance of each other, zero if
+    // they already are, or infinity if they never do
+    static float timeToContact(const sf::Vector2f& offset,
+        const sf::Vector2f& relative, float squared_distance);
+};
+
+#endif
@@ -0,0 +1,70 @@
+#include "ConcurrentUnionFind.hpp"
+
+// For swapping roots
+#include <utility>
+
+// Constructor
+
+ConcurrentUnionFind::ConcurrentUnionFind() :
+elementCount(0), capacity(0)
+{}
+
+// Setup
+
+void ConcurrentUnionFind::reset(size_t element_count)
+{
+    if (element_count > this->capacity)
+    {
+        this->parents.reset(new std::atomic<uint32_t>[element_count]);
+        this->capacity = element_count;
+    }
+
+    this->elementCount = element_count;
+    for (size_t elementIter = 0; elementIter < element_count; ++elementIter)
+        this->parents[elementIter].store(elementIter, std::memory_order_relaxed);
+}
+
+size_t ConcurrentUnionFind::size() const
+{return this->elementCount;}
+
+// Queries and merging
+
+uint32_t ConcurrentUnionFind::find(uint32_t element)
+{
+    while (true)
+    {
+        uint32_t parent = this->parents[element].load(std::memory_order_relaxed);
+        if (parent == element)
+            return element;
+
+        // Point the element to its grandparent. Losing the race is fine,
+        // someone else already shortened the path
+        uint32_t grandParent = this->parents[parent].load(std::memory_order_relaxed);
+        if (parent != grandParent)
+            this->parents[element].compare_exchange_weak(parent, grandParent);
+
+        element = grandParent;
+    }
+}
+
+void ConcurrentUnionFind::unite(uint32_t a, uint32_t b)
+{
+    while (true)
+    {
+        a = this->find(a);
+        b = this->find(b);
+
+        if (a == b)
+            return;
+
+        // Always hang the larger root under the smaller one, so links only
+        // ever point downwards and can't form cycles
+        if (a < b)
+            std::swap(a, b);
+
+        // Only succeeds if a is still a root. Otherwise retry from the top
+        uint32_t expected = a;
+        if (this->parents[a].compare_exchange_strong(expected, b))
+            return;
+    }
+}
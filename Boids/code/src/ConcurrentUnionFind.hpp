@@ -0,0 +1,37 @@
+#ifndef CONCURRENT_UNION_FIND_HPP
+#define CONCURRENT_UNION_FIND_HPP
+
+// For lock-free linking
+#include <atomic>
+#include <cstdint>
+#include <memory>
+
+// Disjoint sets over the indices [0, size), safe to unite and find from any
+// number of threads at once. Roots are always the smallest index of their
+// set, so the result doesn't depend on the order of the unions
+class ConcurrentUnionFind
+{
+    public:
+        // Default-construct an empty structure
+        ConcurrentUnionFind();
+
+        // Put every element in its own set, growing storage if needed.
+        // Not thread-safe
+        void reset(size_t element_count);
+
+        // Get the amount of elements
+        size_t size() const;
+
+        // Get the root of an element's set, halving its path on the way
+        uint32_t find(uint32_t element);
+
+        // Merge the sets of two elements
+        void unite(uint32_t a, uint32_t b);
+
+    private:
+        std::unique_ptr<std::atomic<uint32_t>[]> parents;
+        size_t elementCount;
+        size_t capacity;
+};
+
+#endif
@@ -0,0 +1,68 @@
+#include "DensityField.hpp"
+
+// For clamping cells
+#include <algorithm>
+
+// For headings
+#include "QuickMath.hpp"
+
+// Constructor
+
+DensityField::DensityField() :
+enabled(false), cellSize(16), decay(0.95), columns(0), rows(0)
+{}
+
+// Setup
+
+void DensityField::resize(const sf::FloatRect& world_bounds)
+{
+    this->bounds = world_bounds;
+    this->columns = std::max(1.f, std::ceil(world_bounds.width / this->cellSize));
+    this->rows = std::max(1.f, std::ceil(world_bounds.height / this->cellSize));
+
+    this->densities.assign(this->columns * this->rows, 0);
+    this->headings.assign(this->columns * this->rows, sf::Vector2f(0, 0));
+}
+
+// Accumulation
+
+void DensityField::accumulate(const BoidStorage& boids)
+{
+    for (size_t cell = 0; cell < this->densities.size(); ++cell)
+    {
+        this->densities[cell] *= this->decay;
+        this->headings[cell] *= this->decay;
+    }
+
+    for (size_t boidIter = 0; boidIter < boids.size(); ++boidIter)
+    {
+        const sf::Vector2f& position = boids[boidIter].getPosition();
+        float column = std::floor((position.x - this->bounds.left) / this->cellSize);
+        float row = std::floor((position.y - this->bounds.top) / this->cellSize);
+
+        size_t cell = 
+            static_cast<size_t>(std::clamp(row, 0.f, this->rows - 1.f)) * this->columns
+            + static_cast<size_t>(std::clamp(column, 0.f, this->columns - 1.f));
+
+        float direction = QuickMath::degreesToRadians(boids[boidIter].getRotation());
+        this->densities[cell] += 1;
+        this->headings[cell] += sf::Vector2f(std::cos(direction), std::sin(direction));
+    }
+}
+
+// Getters
+
+const sf::FloatRect& DensityField::getBounds() const
+{return this->bounds;}
+
+size_t DensityField::getColumns() const
+{return this->columns;}
+
+size_t DensityField::getRows() const
+{return this->rows;}
+
+const std::vector<float>& DensityField::getDensities() const
+{return this->densities;}
+
+const std::vector<sf::Vector2f>& DensityField::getHeadings() const
+{return this->headings;}
@@ -0,0 +1,57 @@
+#ifndef DENSITY_FIELD_HPP
+#define DENSITY_FIELD_HPP
+
+// For bounds and headings
+#include <SFML/Graphics.hpp>
+
+// For the field itself
+#include <vector>
+
+// For boid state
+#include "BoidStorage.hpp"
+
+// Coarse grid of exponentially decaying boid density and heading. Each step
+// costs one binning pass over the boids plus one pass over the cells, no
+// matter how large the area being displayed
+class DensityField
+{
+    public:
+        // Whether the field is accumulated at all
+        bool enabled;
+
+        // Side of every cell, in world units
+        float cellSize;
+
+        // Fraction of the previous value kept every step
+        float decay;
+
+        // Default-construct a disabled field
+        DensityField();
+
+        // Cover the given world area, clearing every cell
+        void resize(const sf::FloatRect& world_bounds);
+
+        // Decay every cell, then add each boid to its own
+        void accumulate(const BoidStorage& boids);
+
+        // Get the area covered, and its size in cells
+        const sf::FloatRect& getBounds() const;
+        size_t getColumns() const;
+        size_t getRows() const;
+
+        // Get the decayed amount of boids in a cell, row after row
+        const std::vector<float>& getDensities() const;
+
+        // Get the decayed sum of boid headings in a cell, row after row
+        const std::vector<sf::Vector2f>& getHeadings() const;
+
+    private:
+        sf::FloatRect bounds;
+        size_t columns;
+        size_t rows;
+
+        std::vector<float> densities;
+        std::vector<sf::Vector2f> headings;
+};
+
+#endif
@@ -0,0 +1,76 @@
+#include "DensityLayer.hpp"
+
+// For clamping densities
+#include <algorithm>
+
+// For headings as hues
+#include "QuickMath.hpp"
+
+// Get a fully saturated, fully bright color of the given hue, in degrees
+static sf::Color hueToColor(float hue)
+{
+    float sector = QuickMath::modulus(hue, 0.f, 360.f) / 60.f;
+    float rising = sector - std::floor(sector);
+    sf::Uint8 up = 255 * rising, down = 255 * (1 - rising);
+
+    switch (static_cast<int>(sector) % 6)
+    {
+        case 0: return sf::Color(255, up, 0);
+        case 1: return sf::Color(down, 255, 0);
+        case 2: return sf::Color(0, 255, up);
+        case 3: return sf::Color(0, down, 255);
+        case 4: return sf::Color(up, 0, 255);
+        default: return sf::Color(255, 0, down);
+    }
+}
+
+// Constructor
+
+DensityLayer::DensityLayer() :
+fullDensity(4)
+{}
+
+// Uploading
+
+void DensityLayer::update(const DensityField& field)
+{
+    size_t columns = field.getColumns(), rows = field.getRows();
+    if (columns == 0 || rows == 0)
+        return;
+
+    // Recreate the texture only when the field changes size
+    if (this->texture.getSize() != sf::Vector2u(columns, rows))
+    {
+        this->texture.create(columns, rows);
+        this->texture.setSmooth(true);
+        this->sprite.setTexture(this->texture, true);
+    }
+
+    const std::vector<float>& densities = field.getDensities();
+    const std::vector<sf::Vector2f>& headings = field.getHeadings();
+
+    this->pixels.resize(columns * rows * 4);
+    for (size_t cell = 0; cell < columns * rows; ++cell)
+    {
+        sf::Color color = hueToColor(QuickMath::getDegrees(headings[cell]));
+        color.a = 255 * std::min(1.f, densities[cell] / this->fullDensity);
+
+        sf::Uint8* pixel = &this->pixels[cell * 4];
+        pixel[0] = color.r; pixel[1] = color.g; pixel[2] = color.b; pixel[3] = color.a;
+    }
+
+    this->texture.update(this->pixels.data());
+
+    // Stretch every pixel over the cell it stands for
+    const sf::FloatRect& bounds = field.getBounds();
+    this->sprite.setPosition(bounds.left, bounds.top);
+    this->sprite.setScale(field.cellSize, field.cellSize);
+}
+
+// Rendering
+
+void DensityLayer::draw(sf::RenderTarget& target, sf::RenderStates states) const
+{
+    if (this->texture.getSize().x != 0)
+        target.draw(this->sprite, states);
+}
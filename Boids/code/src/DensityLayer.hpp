@@ -0,0 +1,36 @@
+#ifndef DENSITY_LAYER_HPP
+#define DENSITY_LAYER_HPP
+
+// For rendering
+#include <SFML/Graphics.hpp>
+
+// For pixels
+#include <vector>
+
+// For the field being shown
+#include "DensityField.hpp"
+
+// Shows a density field as a small texture stretched over the world, one
+// pixel per cell. Hue follows the average heading, opacity the density
+class DensityLayer : public sf::Drawable
+{
+    public:
+        // Density at which cells are fully opaque
+        float fullDensity;
+
+        // Default-construct an empty layer
+        DensityLayer();
+
+        // Upload the current state of a field
+        void update(const DensityField& field);
+
+        // Draw the latest uploaded field
+        virtual void draw(sf::RenderTarget& target, sf::RenderStates states) const override;
+
+    private:
+        sf::Texture texture;
+        sf::Sprite sprite;
+        std::vector<sf::Uint8> pixels;
+};
+
+#endif
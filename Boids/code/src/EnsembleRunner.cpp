@@ -0,0 +1,138 @@
+#include "EnsembleRunner.hpp"
+
+// For timing runs
+#include <chrono>
+
+// For CSV output
+#include <fstream>
+
+// For the worlds themselves
+#include "BoidWorld.hpp"
+
+// Constructor
+
+EnsembleRunner::EnsembleRunner() :
+cohesionValues{1}, allignmentValues{1}, separationValues{1},
+senseRadiusValues{50}, repeats(1), baseSeed(0),
+bounds(0, 0, 1080, 720), turnSpeed(0.2), flySpeed(0.4),
+boidCount(100), stepCount(1000), analyticsInterval(100)
+{}
+
+// Sweep expansion
+
+std::vector<EnsembleRun> EnsembleRunner::buildRuns() const
+{
+    std::vector<EnsembleRun> runs;
+    runs.reserve(cohesionValues.size() * allignmentValues.size()
+        * separationValues.size() * senseRadiusValues.size() * repeats);
+
+    // Every seed gets its own run index, so seeds never repeat across
+    // grid points
+    EnsembleRun run;
+    for (float cohesion : cohesionValues)
+    for (float allignment : allignmentValues)
+    for (float separation : separationValues)
+    for (float radius : senseRadiusValues)
+    for (size_t repeat = 0; repeat < repeats; ++repeat)
+    {
+        run.index = runs.size();
+        run.seed = baseSeed + static_cast<unsigned>(run.index);
+        run.cohesionC = cohesion;
+        run.allignmentC = allignment;
+        run.separationC = separation;
+        run.senseRadius = radius;
+
+        runs.push_back(run);
+    }
+
+    return runs;
+}
+
+// Running
+
+std::vector<EnsembleResult> EnsembleRunner::run(ThreadPool& pool) const
+{
+    std::vector<EnsembleRun> runs = this->buildRuns();
+    std::vector<EnsembleResult> results(runs.size());
+
+    // Each task owns its world and writes to its own result slot, so no
+    // further synchronization is needed
+    for (size_t runIter = 0; runIter < runs.size(); ++runIter)
+        pool.submit([this, &runs, &results, runIter]
+            {results[runIter] = this->simulate(runs[runIter]);});
+
+    pool.wait();
+    return results;
+}
+
+EnsembleResult EnsembleRunner::simulate(const EnsembleRun& run) const
+{
+    BoidWorld world;
+    world.setBounds(this->bounds);
+    world.turnSpeed = this->turnSpeed;
+    world.flySpeed = this->flySpeed;
+    world.senseRadius = run.senseRadius;
+
+    world.cohesionC = run.cohesionC;
+    world.allignmentC = run.allignmentC;
+    world.separationC = run.separationC;
+
+    world.seed = run.seed;
+    world.setBoidCount(this->boidCount);
+    world.analytics.interval = this->analyticsInterval;
+
+    EnsembleResult result;
+    result.run = run;
+
+    // Step the world, sampling its order parameter along the way
+    double polarizationSum = 0;
+    auto start = std::chrono::steady_clock::now();
+    for (size_t stepIter = 0; stepIter < this->stepCount; ++stepIter)
+    {
+        world.update();
+        polarizationSum += world.getPolarization();
+    }
+    auto end = std::chrono::steady_clock::now();
+
+    result.seconds = std::chrono::duration<double>(end - start).count();
+    result.stepsPerSecond = result.seconds > 0 
+        ? this->stepCount / result.seconds : 0;
+
+    result.finalPolarization = world.getPolarization();
+    result.meanPolarization = this->stepCount > 0
+        ? polarizationSum / this->stepCount : result.finalPolarization;
+
+    result.flockCount = world.analytics.flockCount;
+    result.largestFlock = world.analytics.largestFlock;
+    result.analyticsOverhead = world.analytics.overheadFraction;
+
+    return result;
+}
+
+// Output
+
+bool EnsembleRunner::writeCsv(const std::string& csv_path,
+    const std::vector<EnsembleResult>& results)
+{
+    std::ofstream csv(csv_path);
+    if (!csv)
+        return false;
+
+    csv << "run,seed,cohesionC,allignmentC,separationC,senseRadius,"
+        "seconds,stepsPerSecond,finalPolarization,meanPolarization,"
+        "flockCount,largestFlock,analyticsOverhead\n";
+
+    for (const EnsembleResult& result : results)
+    {
+        csv << result.run.index << ',' << result.run.seed << ','
+            << result.run.cohesionC << ',' << result.run.allignmentC << ','
+            << result.run.separationC << ',' << result.run.senseRadius << ','
+            << result.seconds << ',' << result.stepsPerSecond << ','
+            << result.finalPolarization << ',' 
+            << result.meanPolarization << ','
+            << result.flockCount << ',' << result.largestFlock << ','
+            << result.analyticsOverhead << '\n';
+    }
+
+    return static_cast<bool>(csv);
+}
@@ -0,0 +1,89 @@
+#ifndef ENSEMBLE_RUNNER_HPP
+#define ENSEMBLE_RUNNER_HPP
+
+// For simulation bounds
+#include <SFML/Graphics.hpp>
+
+// For sweep values and results
+#include <string>
+#include <vector>
+
+// For running worlds concurrently
+#include "ThreadPool.hpp"
+
+// Parameters of a single world within a sweep
+struct EnsembleRun
+{
+    size_t index;
+    unsigned seed;
+
+    float cohesionC;
+    float allignmentC;
+    float separationC;
+    float senseRadius;
+};
+
+// Summary metrics of a finished run
+struct EnsembleResult
+{
+    EnsembleRun run;
+
+    // Wall-clock time spent stepping the world
+    double seconds;
+    double stepsPerSecond;
+
+    // Order parameter at the end of the run, and averaged over every step
+    float finalPolarization;
+    float meanPolarization;
+
+    // Flock structure as of the latest analyzed step
+    size_t flockCount;
+    size_t largestFlock;
+    double analyticsOverhead;
+};
+
+// Runs a grid of independent worlds over a thread pool, one world per task
+class EnsembleRunner
+{
+    public:
+        // Values swept over. Every combination becomes a grid point
+        std::vector<float> cohesionValues;
+        std::vector<float> allignmentValues;
+        std::vector<float> separationValues;
+        std::vector<float> senseRadiusValues;
+
+        // Independent seeds per grid point
+        size_t repeats;
+        unsigned baseSeed;
+
+        // Parameters shared by every world
+        sf::FloatRect bounds;
+        float turnSpeed;
+        float flySpeed;
+        size_t boidCount;
+        size_t stepCount;
+
+        // Steps between flock analyses, zero to disable them
+        size_t analyticsInterval;
+
+        // Default-construct a runner for a single default world
+        EnsembleRunner();
+
+        // Expand the sweep into one entry per world
+        std::vector<EnsembleRun> buildRuns() const;
+
+        // Simulate every world on the pool and gather their summaries,
+        // ordered as returned by buildRuns()
+        std::vector<EnsembleResult> run(ThreadPool& pool) const;
+
+        // Write results as CSV, one row per run. False if the file couldn't
+        // be written
+        static bool writeCsv(const std::string& csv_path,
+            const std::vector<EnsembleResult>& results);
+
+    private:
+        // Simulate a single world
+        EnsembleResult simulate(const EnsembleRun& run) const;
+};
+
+#endif
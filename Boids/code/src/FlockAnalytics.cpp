@@ -0,0 +1,97 @@
+#include "FlockAnalytics.hpp"
+
+// For sorting clusters
+#include <algorithm>
+
+// For boid state
+#include "BoidStorage.hpp"
+
+// For headings
+#include "QuickMath.hpp"
+
+// Constructor
+
+FlockAnalytics::FlockAnalytics() :
+interval(0), minFlockSize(2), analyzedStep(0), flockCount(0),
+largestFlock(0), polarization(0), overheadFraction(0), plainStepSeconds(0)
+{}
+
+// Analysis
+
+bool FlockAnalytics::isDue(size_t step) const
+{return this->interval != 0 && step % this->interval == 0;}
+
+ConcurrentUnionFind& FlockAnalytics::begin(size_t boid_count)
+{
+    this->flockUnion.reset(boid_count);
+    return this->flockUnion;
+}
+
+void FlockAnalytics::finish(const BoidStorage& boids, size_t step)
+{
+    size_t boidCount = boids.size();
+
+    this->rootSizes.assign(boidCount, 0);
+    this->rootPositions.assign(boidCount, sf::Vector2f(0, 0));
+    this->rootHeadings.assign(boidCount, sf::Vector2f(0, 0));
+
+    // Accumulate every boid onto its set's root
+    sf::Vector2f headingSum(0, 0);
+    for (size_t boidIter = 0; boidIter < boidCount; ++boidIter)
+    {
+        uint32_t root = this->flockUnion.find(boidIter);
+
+        float direction = QuickMath::degreesToRadians
+            (boids[boidIter].getRotation());
+        sf::Vector2f heading(std::cos(direction), std::sin(direction));
+
+        ++this->rootSizes[root];
+        this->rootPositions[root] += boids[boidIter].getPosition();
+        this->rootHeadings[root] += heading;
+        headingSum += heading;
+    }
+
+    // Turn each root's sums into a cluster
+    this->clusters.clear();
+    this->flockCount = 0;
+    for (size_t root = 0; root < boidCount; ++root)
+    {
+        size_t size = this->rootSizes[root];
+        if (size == 0)
+            continue;
+
+        FlockCluster cluster;
+        cluster.size = size;
+        cluster.centroid = this->rootPositions[root] / static_cast<float>(size);
+        cluster.heading = QuickMath::getDegrees(this->rootHeadings[root]);
+        cluster.allignment = 
+            QuickMath::getMagnitude(this->rootHeadings[root]) / size;
+
+        this->clusters.push_back(cluster);
+        if (size >= this->minFlockSize)
+            ++this->flockCount;
+    }
+
+    std::sort(this->clusters.begin(), this->clusters.end(),
+        [](const FlockCluster& a, const FlockCluster& b) {return a.size > b.size;});
+
+    this->analyzedStep = step;
+    this->largestFlock = this->clusters.empty() ? 0 : this->clusters.front().size;
+    this->polarization = boidCount == 0 
+        ? 0 : QuickMath::getMagnitude(headingSum) / boidCount;
+}
+
+// Cost tracking
+
+void FlockAnalytics::recordStep(double seconds, bool analyzed)
+{
+    if (!analyzed)
+    {
+        // Exponential moving average, seeded by the first sample
+        this->plainStepSeconds = this->plainStepSeconds == 0
+            ? seconds : this->plainStepSeconds * 0.9 + seconds * 0.1;
+    }
+
+    else if (this->plainStepSeconds > 0)
+        this->overheadFraction = seconds / this->plainStepSeconds - 1;
+}
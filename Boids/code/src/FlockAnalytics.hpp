@@ -0,0 +1,81 @@
+#ifndef FLOCK_ANALYTICS_HPP
+#define FLOCK_ANALYTICS_HPP
+
+// For centroids
+#include <SFML/Graphics.hpp>
+
+// For clusters
+#include <vector>
+
+// For grouping boids into flocks
+#include "ConcurrentUnionFind.hpp"
+
+// Forward declaration, only handled through references
+class BoidStorage;
+
+// A set of boids transitively linked by being within senseRadius
+struct FlockCluster
+{
+    size_t size;
+
+    // Plain average position, ignoring wraparound
+    sf::Vector2f centroid;
+
+    // Orientation of the average heading, in degrees
+    float heading;
+
+    // Length of the average heading, from 0 (random) to 1 (aligned)
+    float allignment;
+};
+
+// In-process flock structure measurement. Neighbors are united while the
+// steering pass visits them anyway, so the only extra work is an O(n)
+// gather at the end of the analyzed steps
+class FlockAnalytics
+{
+    public:
+        // Analyze every this many steps. Zero disables analytics
+        size_t interval;
+
+        // Clusters smaller than this aren't counted as flocks
+        size_t minFlockSize;
+
+        // Latest results. Clusters are sorted by decreasing size
+        std::vector<FlockCluster> clusters;
+        size_t analyzedStep;
+        size_t flockCount;
+        size_t largestFlock;
+        float polarization;
+
+        // Cost of the latest analyzed step relative to a plain one, as
+        // a fraction of the latter
+        double overheadFraction;
+
+        // Default-construct with analytics disabled
+        FlockAnalytics();
+
+        // Check whether the given step should be analyzed
+        bool isDue(size_t step) const;
+
+        // Prepare the neighbor sets for an analyzed step
+        ConcurrentUnionFind& begin(size_t boid_count);
+
+        // Gather per-cluster metrics once every neighbor was united
+        void finish(const BoidStorage& boids, size_t step);
+
+        // Account for the duration of a whole step
+        void recordStep(double seconds, bool analyzed);
+
+    private:
+        ConcurrentUnionFind flockUnion;
+
+        // Per-root accumulators, reused across analyses
+        std::vector<size_t> rootSizes;
+        std::vector<sf::Vector2f> rootPositions;
+        std::vector<sf::Vector2f> rootHeadings;
+
+        // Moving average of the duration of steps without analytics
+        double plainStepSeconds;
+};
+
+#endif
@@ -0,0 +1,97 @@
+#include "FlockView3D.hpp"
+
+// For vector math
+#include "QuickMath.hpp"
+
+// For shading by depth
+#include <algorithm>
+
+// Constructor
+
+FlockView3D::FlockView3D() :
+yaw(0), pitch(20), fieldOfView(60), boidLength(1)
+{}
+
+// Building
+
+void FlockView3D::build(const BoidWorld3D& world, const sf::Vector2f& viewport_size)
+{
+    this->vertices.clear();
+
+    // Orbit far enough out for the whole box to fit the field of view
+    float yawRadians = QuickMath::degreesToRadians(this->yaw);
+    float pitchRadians = this->pitch * std::numbers::pi / 180.0;
+    float halfFov = this->fieldOfView * std::numbers::pi / 360.0;
+
+    sf::Vector3f forward(std::cos(pitchRadians) * std::sin(yawRadians),
+        -std::sin(pitchRadians), std::cos(pitchRadians) * std::cos(yawRadians));
+    sf::Vector3f right = QuickMath::getNormalized
+        (QuickMath::crossProduct(sf::Vector3f(0, 1, 0), forward));
+    sf::Vector3f up = QuickMath::crossProduct(forward, right);
+
+    sf::Vector3f center = world.boundsCorner + world.boundsSize / 2.f;
+    float boxRadius = QuickMath::getMagnitude(world.boundsSize) / 2;
+    float distance = boxRadius / std::tan(halfFov) + boxRadius;
+    sf::Vector3f eye = center - forward * distance;
+
+    float focalLength = viewport_size.y / 2 / std::tan(halfFov);
+    sf::Vector2f screenCenter = viewport_size / 2.f;
+
+    // Depths boids may be at, for shading
+    float nearest = distance - boxRadius, farthest = distance + boxRadius;
+
+    auto project = [&](const sf::Vector3f& point, float& depth)
+    {
+        sf::Vector3f relative = point - eye;
+        depth = QuickMath::dotProduct(relative, forward);
+
+        return screenCenter + sf::Vector2f(QuickMath::dotProduct(relative, right),
+            -QuickMath::dotProduct(relative, up)) * (focalLength / depth);
+    };
+
+    for (const Boid3D& boid : world.boids)
+    {
+        float depth, tipDepth;
+        sf::Vector2f base = project(boid.position, depth);
+        sf::Vector2f tip = project(boid.position + boid.heading * this->boidLength, tipDepth);
+        if (depth <= 0 || tipDepth <= 0)
+            continue;
+
+        // Boids flying at the camera keep a minimal size
+        sf::Vector2f along = tip - base;
+        float length = QuickMath::getMagnitude(along);
+        if (length == 0)
+        {
+            along = sf::Vector2f(0, -1);
+            length = 1;
+        }
+
+        float minLength = this->boidLength * focalLength / depth * 0.3f;
+        if (length < minLength)
+        {
+            along = along / length * minLength;
+            tip = base + along;
+            length = minLength;
+        }
+
+        sf::Vector2f across(-along.y * 0.3f, along.x * 0.3f);
+
+        float shade = 1 - 0.75f * std::clamp((depth - nearest) / (farthest - nearest), 0.f, 1.f);
+        sf::Color color(255 * shade, 255 * shade, 255 * shade);
+
+        this->vertices.emplace_back(tip, color);
+        this->vertices.emplace_back(base + across, color);
+        this->vertices.emplace_back(base - across, color);
+    }
+}
+
+size_t FlockView3D::getDrawnCount() const
+{return this->vertices.size() / 3;}
+
+// Drawing
+
+void FlockView3D::draw(sf::RenderTarget& target, sf::RenderStates states) const
+{
+    if (!this->vertices.empty())
+        target.draw(this->vertices.data(), this->vertices.size(), sf::Triangles, states);
+}
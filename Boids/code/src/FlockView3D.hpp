@@ -0,0 +1,47 @@
+#ifndef FLOCK_VIEW_3D_HPP
+#define FLOCK_VIEW_3D_HPP
+
+// For rendering
+#include <SFML/Graphics.hpp>
+
+// For vertices
+#include <vector>
+
+// For the state being drawn
+#include "BoidWorld3D.hpp"
+
+// Draws a 3D world in perspective onto the screen, seen from outside its
+// box while orbiting around its center. Every boid is a small triangle
+// pointing along its projected heading, darker the farther away it is
+class FlockView3D : public sf::Drawable
+{
+    public:
+        // Orbit angles around the box's vertical axis and above its
+        // horizontal plane, in degrees
+        float yaw;
+        float pitch;
+
+        // Vertical field of view, in degrees
+        float fieldOfView;
+
+        // Length of every boid, in world units
+        float boidLength;
+
+        // Default-construct looking at the box from the front
+        FlockView3D();
+
+        // Rebuild the vertices from every boid of a world, projected onto a
+        // viewport of the given size
+        void build(const BoidWorld3D& world, const sf::Vector2f& viewport_size);
+
+        // Get the amount of boids in front of the camera in the latest build
+        size_t getDrawnCount() const;
+
+        // Draw the latest built vertices, in viewport coordinates
+        virtual void draw(sf::RenderTarget& target, sf::RenderStates states) const override;
+
+    private:
+        std::vector<sf::Vertex> vertices;
+};
+
+#endif
@@ -0,0 +1,133 @@
+#include "GridHierarchy.hpp"
+
+// For clamping cells
+#include <algorithm>
+#include <cmath>
+
+// For powers of two
+#include <bit>
+
+// Constructor
+
+GridHierarchy::GridHierarchy() :
+finestCellSize(1), levelCount(1), side(1)
+{}
+
+// Building
+
+void GridHierarchy::build(std::span<const sf::Vector2f> points, const sf::FloatRect& grid_area, 
+    float min_cell_size, float max_cell_size)
+{
+    size_t pointCount = points.size();
+
+    // Keys are 32 bits wide, so sides stop at 2^16 cells
+    const size_t maxSide = size_t(1) << 16;
+    const size_t maxCells = std::max<size_t>(4 * pointCount, 1 << 16);
+
+    this->area = grid_area;
+    this->finestCellSize = std::max(min_cell_size, 1e-3f);
+    while (true)
+    {
+        float cells = std::max(std::ceil(grid_area.width / this->finestCellSize),
+            std::ceil(grid_area.height / this->finestCellSize));
+        this->side = std::bit_ceil(static_cast<size_t>(std::clamp(cells, 1.f, float(maxSide))));
+
+        if (cells <= maxSide && this->side * this->side <= maxCells)
+            break;
+
+        this->finestCellSize *= 2;
+    }
+
+    // Levels double until wide enough, or down to a single cell
+    this->levelCount = 1;
+    while (this->getCellSize(this->levelCount - 1) < max_cell_size 
+        && (this->side >> (this->levelCount - 1)) > 1)
+        ++this->levelCount;
+
+    this->pointKeys.resize(pointCount);
+    this->sortedIndices.resize(pointCount);
+    this->sortedPoints.resize(pointCount);
+    this->cellStarts.assign(this->side * this->side + 1, 0);
+
+    // Counting sort by finest key: count, prefix-sum, then scatter
+    for (size_t pointIter = 0; pointIter < pointCount; ++pointIter)
+    {
+        uint32_t key = interleave(this->finestCellOf(points[pointIter].x - grid_area.left),
+            this->finestCellOf(points[pointIter].y - grid_area.top));
+
+        this->pointKeys[pointIter] = key;
+        ++this->cellStarts[key];
+    }
+
+    for (size_t cellIter = 1; cellIter < this->cellStarts.size(); ++cellIter)
+        this->cellStarts[cellIter] += this->cellStarts[cellIter - 1];
+
+    // Scatter backwards, leaving every entry at its cell's start and points
+    // in index order within each cell
+    for (size_t pointIter = pointCount; pointIter-- > 0;)
+    {
+        uint32_t sorted = --this->cellStarts[this->pointKeys[pointIter]];
+        this->sortedIndices[sorted] = pointIter;
+        this->sortedPoints[sorted] = points[pointIter];
+    }
+}
+
+// Getters
+
+size_t GridHierarchy::getLevelCount() const
+{return this->levelCount;}
+
+float GridHierarchy::getCellSize(size_t level) const
+{return std::ldexp(this->finestCellSize, level);}
+
+size_t GridHierarchy::levelFor(float radius) const
+{
+    size_t level = 0;
+    while (level + 1 < this->levelCount && this->getCellSize(level) < radius)
+        ++level;
+
+    return level;
+}
+
+size_t GridHierarchy::columnOf(float x, size_t level) const
+{return this->finestCellOf(x - this->area.left) >> level;}
+
+size_t GridHierarchy::rowOf(float y, size_t level) const
+{return this->finestCellOf(y - this->area.top) >> level;}
+
+size_t GridHierarchy::cellBegin(size_t column, size_t row, size_t level) const
+{
+    // A coarse cell covers the finest keys sharing its key as a prefix
+    return this->cellStarts[size_t(interleave(column, row)) << (2 * level)];
+}
+
+size_t GridHierarchy::cellEnd(size_t column, size_t row, size_t level) const
+{return this->cellStarts[(size_t(interleave(column, row)) + 1) << (2 * level)];}
+
+const std::vector<uint32_t>& GridHierarchy::getSortedIndices() const
+{return this->sortedIndices;}
+
+const std::vector<sf::Vector2f>& GridHierarchy::getSortedPoints() const
+{return this->sortedPoints;}
+
+uint32_t GridHierarchy::interleave(uint32_t column, uint32_t row)
+{
+    // Spread the low 16 bits of each apart, one zero between every two
+    auto spread = [](uint32_t bits)
+    {
+        bits &= 0xFFFF;
+        bits = (bits | (bits << 8)) & 0x00FF00FF;
+        bits = (bits | (bits << 4)) & 0x0F0F0F0F;
+        bits = (bits | (bits << 2)) & 0x33333333;
+        bits = (bits | (bits << 1)) & 0x55555555;
+        return bits;
+    };
+
+    return spread(column) | (spread(row) << 1);
+}
+
+size_t GridHierarchy::finestCellOf(float offset) const
+{
+    float cell = std::floor(offset / this->finestCellSize);
+    return static_cast<size_t>(std::clamp(cell, 0.f, this->side - 1.f));
+}
@@ -0,0 +1,84 @@
+#ifndef GRID_HIERARCHY_HPP
+#define GRID_HIERARCHY_HPP
+
+// For positions and bounds
+#include <SFML/Graphics.hpp>
+
+// For fixed-width keys and indices
+#include <cstdint>
+
+// For the points to bin
+#include <span>
+
+// For the binned elements
+#include <vector>
+
+// Square cells over a fixed area at several resolutions, every level's
+// cells twice as wide as the one below's. Cells of the finest level are
+// numbered along a Z-order curve, interleaving the bits of their column
+// and row, so that every cell of a coarser level covers a contiguous range
+// of finer keys: dropping two bits per level. Points are counting-sorted
+// once by finest key, and that single sort and its cell starts serve every
+// level. Points outside the area are clamped into the border cells
+class GridHierarchy
+{
+    public:
+        // Default-construct an empty hierarchy
+        GridHierarchy();
+
+        // Bin every point over the area, with the finest cells at least
+        // min_cell_size wide and levels added until cells are at least
+        // max_cell_size wide. Finest cells get coarsened until there are
+        // no more than a few per point, so memory tracks the points
+        void build(std::span<const sf::Vector2f> points, const sf::FloatRect& grid_area, 
+            float min_cell_size, float max_cell_size);
+
+        // Get the amount of levels, and the cell size of one. Level zero
+        // is the finest
+        size_t getLevelCount() const;
+        float getCellSize(size_t level) const;
+
+        // Get the finest level whose cells are at least as wide as a
+        // radius, so that a query only spans the 3x3 cells around it, or
+        // the coarsest one
+        size_t levelFor(float radius) const;
+
+        // Get the column or row holding a coordinate at a level, clamped
+        // to the area
+        size_t columnOf(float x, size_t level) const;
+        size_t rowOf(float y, size_t level) const;
+
+        // Get the range of a cell at a level within the sorted points
+        size_t cellBegin(size_t column, size_t row, size_t level) const;
+        size_t cellEnd(size_t column, size_t row, size_t level) const;
+
+        // Get the original index and position of every point, sorted by
+        // finest key
+        const std::vector<uint32_t>& getSortedIndices() const;
+        const std::vector<sf::Vector2f>& getSortedPoints() const;
+
+        // Get the Z-order key of a cell, interleaving column and row bits
+        static uint32_t interleave(uint32_t column, uint32_t row);
+
+    private:
+        sf::FloatRect area;
+        float finestCellSize;
+        size_t levelCount;
+
+        // Finest cells along either axis, a power of two so that every
+        // level's keys are dense
+        size_t side;
+
+        // Every point's finest key, and where each finest cell's run
+        // starts. The last entry holds the amount of points
+        std::vector<uint32_t> pointKeys;
+        std::vector<uint32_t> cellStarts;
+
+        std::vector<uint32_t> sortedIndices;
+        std::vector<sf::Vector2f> sortedPoints;
+
+        // Get the finest column or row holding an offset into the area
+        size_t finestCellOf(float offset) const;
+};
+
+#endif
@@ -0,0 +1,107 @@
+#include "HashedGrid.hpp"
+
+// For binary searches
+#include <algorithm>
+
+// For cell coordinates
+#include <cmath>
+
+// Constructor
+
+HashedGrid::HashedGrid() :
+cellSize(1)
+{}
+
+// Building
+
+void HashedGrid::build(std::span<const sf::Vector2f> points, float cell_size)
+{
+    this->cellSize = cell_size;
+
+    size_t pointCount = points.size();
+    this->sortedKeys.resize(pointCount);
+    this->sortedIndices.resize(pointCount);
+    this->scratchKeys.resize(pointCount);
+    this->scratchIndices.resize(pointCount);
+
+    for (size_t pointIter = 0; pointIter < pointCount; ++pointIter)
+    {
+        this->sortedKeys[pointIter] = hashCell
+            (this->cellOf(points[pointIter].x), this->cellOf(points[pointIter].y));
+        this->sortedIndices[pointIter] = pointIter;
+    }
+
+    // Least significant digit radix sort over (key, index) pairs, a byte
+    // at a time. Each pass is stable, so points stay in index order within
+    // a key
+    for (int shift = 0; shift < 32; shift += 8)
+    {
+        size_t counts[256] = {};
+        for (uint32_t key : this->sortedKeys)
+            ++counts[(key >> shift) & 0xFF];
+
+        // A byte shared by every key doesn't reorder anything
+        if (pointCount == 0 || counts[(this->sortedKeys[0] >> shift) & 0xFF] == pointCount)
+            continue;
+
+        size_t start = 0;
+        for (size_t& count : counts)
+        {
+            size_t bucket = count;
+            count = start;
+            start += bucket;
+        }
+
+        for (size_t pointIter = 0; pointIter < pointCount; ++pointIter)
+        {
+            uint32_t key = this->sortedKeys[pointIter];
+            size_t sorted = counts[(key >> shift) & 0xFF]++;
+
+            this->scratchKeys[sorted] = key;
+            this->scratchIndices[sorted] = this->sortedIndices[pointIter];
+        }
+
+        this->sortedKeys.swap(this->scratchKeys);
+        this->sortedIndices.swap(this->scratchIndices);
+    }
+
+    this->sortedPoints.resize(pointCount);
+    for (size_t sorted = 0; sorted < pointCount; ++sorted)
+        this->sortedPoints[sorted] = points[this->sortedIndices[sorted]];
+}
+
+// Lookups
+
+int64_t HashedGrid::cellOf(float coordinate) const
+{return static_cast<int64_t>(std::floor(coordinate / this->cellSize));}
+
+uint32_t HashedGrid::hashCell(int64_t column, int64_t row)
+{
+    // Mix both coordinates together, then fold down to 32 bits
+    uint64_t hash = static_cast<uint64_t>(column) * 0x9E3779B97F4A7C15ull 
+        ^ static_cast<uint64_t>(row) * 0xC2B2AE3D27D4EB4Full;
+
+    hash ^= hash >> 29;
+    hash *= 0xBF58476D1CE4E5B9ull;
+    hash ^= hash >> 32;
+
+    return static_cast<uint32_t>(hash);
+}
+
+void HashedGrid::findKey(uint32_t key, size_t& begin, size_t& end) const
+{
+    auto range = std::equal_range(this->sortedKeys.begin(), this->sortedKeys.end(), key);
+    begin = range.first - this->sortedKeys.begin();
+    end = range.second - this->sortedKeys.begin();
+}
+
+// Getters
+
+float HashedGrid::getCellSize() const
+{return this->cellSize;}
+
+const std::vector<uint32_t>& HashedGrid::getSortedIndices() const
+{return this->sortedIndices;}
+
+const std::vector<sf::Vector2f>& HashedGrid::getSortedPoints() const
+{return this->sortedPoints;}
@@ -0,0 +1,60 @@
+#ifndef HASHED_GRID_HPP
+#define HASHED_GRID_HPP
+
+// For positions
+#include <SFML/Graphics.hpp>
+
+// For fixed-width keys and indices
+#include <cstdint>
+
+// For the points to bin
+#include <span>
+
+// For the binned elements
+#include <vector>
+
+// Square cells over the whole plane, with no bounds. Every point gets the
+// hash of its cell's coordinates as a key, and points are radix-sorted by
+// key, so that every cell's points sit next to each other and are found by
+// binary search. Memory only depends on the amount of points, however far
+// apart they are. Cells whose hashes collide share a run, which is harmless
+// as long as callers check distances anyway
+class HashedGrid
+{
+    public:
+        // Default-construct an empty grid
+        HashedGrid();
+
+        // Bin every point into cells of the given size
+        void build(std::span<const sf::Vector2f> points, float cell_size);
+
+        // Get the cell size
+        float getCellSize() const;
+
+        // Get the column or row holding a coordinate
+        int64_t cellOf(float coordinate) const;
+
+        // Get the key of a cell
+        static uint32_t hashCell(int64_t column, int64_t row);
+
+        // Get the range of a key within the sorted points, empty if no
+        // point has it
+        void findKey(uint32_t key, size_t& begin, size_t& end) const;
+
+        // Get the original index and position of every point, sorted by key
+        const std::vector<uint32_t>& getSortedIndices() const;
+        const std::vector<sf::Vector2f>& getSortedPoints() const;
+
+    private:
+        float cellSize;
+
+        std::vector<uint32_t> sortedKeys;
+        std::vector<uint32_t> sortedIndices;
+        std::vector<sf::Vector2f> sortedPoints;
+
+        // Ping-pong buffers for the radix sort passes
+        std::vector<uint32_t> scratchKeys;
+        std::vector<uint32_t> scratchIndices;
+};
+
+#endif
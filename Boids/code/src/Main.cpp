@@ -2,6 +2,34 @@
 
 #include "BoidManager.hpp"
 
+// For the play rules shared with the headless tools
+#include "PlayRules.hpp"
+
+// For batched drawing of snapshots
+#include "BoidRenderer.hpp"
+
+// For zooming and panning
+#include "Camera.hpp"
+
+// For the density heatmap
+#include "DensityLayer.hpp"
+
+// For overlapping simulation with rendering
+#include "SimulationPipeline.hpp"
+
+// For the volumetric flock and its projection
+#include "BoidWorld3D.hpp"
+#include "FlockView3D.hpp"
+
+// For window title counters
+#include <sstream>
+
+// For cycling through settings
+#include <iterator>
+
+// For the tuning log
+#include <iostream>
+
 int main()
 {
     // Create OpenGL context first via SFML window creation
@@ -23,44 +51,410 @@ int main()
     // Setup boid play rules
     BoidManager::accessInstance().setBounds
         (sf::FloatRect(0, 0, window.getSize().x, window.getSize().y));
-    BoidManager::accessInstance().flySpeed = 0.4;
-    BoidManager::accessInstance().turnSpeed = 0.2;
-    BoidManager::accessInstance().senseRadius = 50;
+    setPlayRules(BoidManager::accessInstance(), 50);
 
-    BoidManager::accessInstance().cohesionC = 1;
-    BoidManager::accessInstance().allignmentC = 2;
-    BoidManager::accessInstance().separationC = 1;
+    // Split every step, and boid placement, across all hardware threads
+    BoidManager::accessInstance().setThreadCount(0);
 
-    // Setup boid count
+    // Setup boid count, placed reproducibly from the seed
+    BoidManager::accessInstance().seed = 1;
     BoidManager::accessInstance().setBoidCount(100);
 
+    // Measure flock structure every so often
+    BoidManager::accessInstance().analytics.interval = 30;
+
+    // Report the configurations picked while auto-tuning
+    BoidManager::accessInstance().tuner.log = &std::cout;
+
+    // Draw boids in a single batch from snapshots of the simulation
+    BoidRenderer renderer;
+    renderer.setTexture(BoidManager::getInstance().getTexture());
+    renderer.boidScale = BoidManager::getInstance().boidScale;
+
+    // Heatmap of density and heading, shown under the boids
+    DensityLayer densityLayer;
+
+    // Look at the whole world at first
+    Camera camera(BoidManager::getInstance().bounds);
+
+    // Volumetric flock under the same play rules, in a box as deep as the
+    // window is tall, seen in perspective while orbiting around it
+    BoidWorld3D volume;
+    volume.setBounds(sf::Vector3f(0, 0, 0), 
+        sf::Vector3f(window.getSize().x, window.getSize().y, window.getSize().y));
+    setPlayRules(volume, 50);
+    volume.setThreadCount(0);
+    volume.seed = 1;
+    volume.setBoidCount(2000);
+
+    FlockView3D volumeView;
+    volumeView.boidLength = 8;
+    bool volumetric = false;
+
+    // Either simulate in line with rendering, or simulate the next step
+    // while the current one is drawn. P switches between both, + and -
+    // spawn and despawn boids, T cycles trail lengths, H toggles the
+    // heatmap, N the neighbor mode, L lazy steering, K a step budget, C
+    // reduced-rate distant chunks, D steering by region and A auto-tuning.
+    // R records history, left and right scrub through it while paused,
+    // and space resumes from wherever scrubbing stopped. V writes every
+    // boid's trajectory to disk, 3 switches to the volumetric flock and O
+    // toggles predictive collision avoidance
+    SimulationPipeline pipeline(BoidManager::accessInstance());
+    BoidSnapshot serialSnapshot;
+    bool pipelined = true;
+    bool scrubbing = false;
+    pipeline.start();
+
+    // File trajectories are written to with V
+    const std::string trajectoryPath = "trajectory.bin";
+
+    // Steps moved per scrub, plain or with shift held
+    const size_t scrubSteps = 10, fastScrubSteps = 500;
+
+    // Boids spawned or despawned per key press
+    const size_t spawnBatch = 50;
+
+    // Neighbor modes cycled through with N
+    const NeighborMode neighborModes[] = 
+        {NeighborMode::Metric, NeighborMode::Topological, NeighborMode::Sampled};
+    const char* neighborModeNames[] = {"metric", "topological", "sampled"};
+    size_t modeSetting = 0;
+
+    // Step budget toggled with K, in seconds
+    const double stepBudget = 0.010;
+
+    // Strength of collision avoidance toggled with O
+    const float avoidanceC = 2;
+
+    // Trail lengths cycled through with T
+    const size_t trailLengths[] = {0, 16, 32, 64};
+    size_t trailSetting = 0;
+
+    // Frame time averages, for serial and pipelined frames respectively
+    double frameMs[2] = {0, 0};
+    sf::Clock frameClock, titleClock;
+
     // Run the simulation as long as the window is open
     while (window.isOpen())
     {
-        // Update one step the simulation
-        BoidManager::accessInstance().update();
+        // Get the step to draw this frame
+        const BoidSnapshot* snapshot = &serialSnapshot;
+        if (volumetric)
+            volume.update();
+
+        else if (pipelined && !scrubbing)
+        {
+            pipeline.fetch();
+            snapshot = &pipeline.latest();
+        }
 
-        // Merely process events in the case of window closing
+        else
+        {
+            // Update one step the simulation, unless scrubbing
+            if (!scrubbing)
+                BoidManager::accessInstance().update();
+
+            BoidManager::getInstance().captureSnapshot(serialSnapshot);
+        }
+
+        // Process events in the case of window closing, mode switching or
+        // camera movement
         sf::Event event;
         while (window.pollEvent(event))
         {
             if (event.type == sf::Event::Closed)
-                window.close();        
+                window.close();
+
+            else if (camera.handleEvent(event, window))
+                continue;
+
+            else if (event.type == sf::Event::KeyPressed)
+            {
+                BoidManager& manager = BoidManager::accessInstance();
+
+                // The world may only be edited while it isn't being stepped,
+                // hence the pauses
+                switch (event.key.code)
+                {
+                    case sf::Keyboard::P:
+                        if (pipelined) pipeline.stop();
+                        else if (!scrubbing && !volumetric) pipeline.start();
+
+                        pipelined = !pipelined;
+                        break;
+
+                    case sf::Keyboard::H:
+                    {
+                        SimulationPipeline::Pause pause(pipeline);
+                        manager.density.enabled = !manager.density.enabled;
+                        break;
+                    }
+
+                    case sf::Keyboard::T:
+                    {
+                        SimulationPipeline::Pause pause(pipeline);
+                        trailSetting = (trailSetting + 1) % std::size(trailLengths);
+                        manager.setTrailLength(trailLengths[trailSetting]);
+                        break;
+                    }
+
+                    case sf::Keyboard::N:
+                    {
+                        SimulationPipeline::Pause pause(pipeline);
+                        modeSetting = (modeSetting + 1) % std::size(neighborModes);
+                        manager.neighborMode = neighborModes[modeSetting];
+                        break;
+                    }
+
+                    case sf::Keyboard::L:
+                    {
+                        SimulationPipeline::Pause pause(pipeline);
+                        manager.lazySteering = !manager.lazySteering;
+                        break;
+                    }
+
+                    case sf::Keyboard::K:
+                    {
+                        SimulationPipeline::Pause pause(pipeline);
+                        manager.stepBudget = manager.stepBudget == 0 ? stepBudget : 0;
+                        manager.steeringPhases = 1;
+                        break;
+                    }
+
+                    case sf::Keyboard::O:
+                    {
+                        SimulationPipeline::Pause pause(pipeline);
+                        manager.avoidanceC = manager.avoidanceC == 0 ? avoidanceC : 0;
+                        break;
+                    }
+
+                    case sf::Keyboard::C:
+                    {
+                        SimulationPipeline::Pause pause(pipeline);
+                        manager.chunks.enabled = !manager.chunks.enabled;
+                        break;
+                    }
+
+                    case sf::Keyboard::D:
+                    {
+                        SimulationPipeline::Pause pause(pipeline);
+                        manager.decomposition.enabled = !manager.decomposition.enabled;
+                        break;
+                    }
+
+                    case sf::Keyboard::A:
+                    {
+                        SimulationPipeline::Pause pause(pipeline);
+                        manager.tuner.enabled = !manager.tuner.enabled;
+                        break;
+                    }
+
+                    case sf::Keyboard::R:
+                    {
+                        SimulationPipeline::Pause pause(pipeline);
+                        manager.history.enabled = !manager.history.enabled;
+                        if (!manager.history.enabled)
+                            manager.history.clear();
+                        break;
+                    }
+
+                    case sf::Keyboard::V:
+                    {
+                        SimulationPipeline::Pause pause(pipeline);
+                        if (manager.trajectory.isOpen())
+                            manager.trajectory.close();
+                        else if (!manager.trajectory.open(trajectoryPath))
+                            std::cerr << "Could not write " << trajectoryPath << std::endl;
+                        break;
+                    }
+
+                    case sf::Keyboard::Left:
+                    case sf::Keyboard::Right:
+                    {
+                        // Simulation stays stopped while scrubbing, and
+                        // has to stop before history can be read
+                        bool wasRunning = pipeline.isRunning();
+                        pipeline.stop();
+                        if (manager.history.empty())
+                        {
+                            if (wasRunning)
+                                pipeline.start();
+                            break;
+                        }
+
+                        scrubbing = true;
+
+                        size_t scrubbed = event.key.shift ? fastScrubSteps : scrubSteps;
+                        size_t step = manager.stepCount;
+                        if (event.key.code == sf::Keyboard::Left)
+                            step = step > manager.history.getFirstStep() + scrubbed 
+                                ? step - scrubbed : manager.history.getFirstStep();
+                        else
+                            step = std::min(step + scrubbed, manager.history.getLastStep());
+
+                        manager.seekHistory(step);
+                        break;
+                    }
+
+                    case sf::Keyboard::Num3:
+                        if (!volumetric) pipeline.stop();
+                        else if (pipelined && !scrubbing) pipeline.start();
+
+                        volumetric = !volumetric;
+                        break;
+
+                    case sf::Keyboard::Space:
+                        if (scrubbing && pipelined && !volumetric)
+                            pipeline.start();
+
+                        scrubbing = false;
+                        break;
+
+                    case sf::Keyboard::Add:
+                    {
+                        SimulationPipeline::Pause pause(pipeline);
+                        manager.addBoids(spawnBatch);
+                        break;
+                    }
+
+                    case sf::Keyboard::Subtract:
+                    {
+                        SimulationPipeline::Pause pause(pipeline);
+
+                        // Despawn the boids currently at the front
+                        std::vector<BoidStorage::BoidId> despawned;
+                        for (size_t boidIter = 0; 
+                            boidIter < std::min(spawnBatch, manager.boids.size()); ++boidIter)
+                            despawned.push_back(manager.boids.getId(boidIter));
+
+                        manager.removeBoids(despawned);
+                        break;
+                    }
+
+                    default:
+                        break;
+                }
+            }
         }
 
+        // Simulate what the camera sees at full rate
+        BoidManager::accessInstance().chunks.setInterest(camera.getViewRect());
+
         // Clear the screen with black
         window.clear(sf::Color::Black);
 
-        // Draw the background
-        window.draw(bg);
+        // The volumetric flock is drawn alone, slowly orbiting around
+        if (volumetric)
+        {
+            volumeView.yaw += 0.1f;
+            volumeView.build(volume, sf::Vector2f(window.getSize()));
 
-        // Draw the simulation
-        window.draw(BoidManager::getInstance());
+            window.setView(window.getDefaultView());
+            window.draw(volumeView);
+        }
+
+        else
+        {
+            // Build this frame's vertices, only for boids the camera may see
+            renderer.build(*snapshot, camera.getViewRect());
+
+            if (snapshot->density.enabled)
+                densityLayer.update(snapshot->density);
+
+            window.setView(camera.getView());
+
+            // Draw the background
+            window.draw(bg);
+
+            // Draw the heatmap
+            if (snapshot->density.enabled)
+                window.draw(densityLayer);
+
+            // Draw the simulation
+            window.draw(renderer);
+        }
 
         // Display the frame
         window.display();
+
+        // Average frame times per mode
+        double& modeMs = frameMs[pipelined];
+        double elapsedMs = frameClock.restart().asSeconds() * 1000.0;
+        modeMs = modeMs == 0 ? elapsedMs : modeMs * 0.95 + elapsedMs * 0.05;
+
+        // Show frame times and the latest flock structure on the title bar
+        if (titleClock.getElapsedTime().asSeconds() > 0.5f)
+        {
+            titleClock.restart();
+
+            std::ostringstream title;
+            title.precision(2);
+            title << std::fixed << "Boid Sim v1 - " 
+                << (pipelined ? "pipelined" : "serial") << " (P)"
+                << " - frame serial: " << frameMs[false] << " ms"
+                << ", pipelined: " << frameMs[true] << " ms"
+                << ", step: " << snapshot->stepSeconds * 1000.0 << " ms, "
+                << neighborModeNames[modeSetting] << " (N)"
+                << " - visible: " << renderer.getVisibleCount()
+                << " / " << renderer.getTotalCount()
+                << " - trail: " << snapshot->trailLength << " steps, "
+                << (snapshot->trailHistoryBytes 
+                    + 3 * snapshot->trails.size() * sizeof(sf::Vector2f) 
+                    + renderer.getTrailMemoryBytes()) / 1e6 << " MB, "
+                << renderer.getTrailSeconds() * 1000.0 << " ms"
+                << " - flocks: " << snapshot->flockCount
+                << ", largest: " << snapshot->largestFlock
+                << ", order: " << snapshot->polarization
+                << ", analytics cost: " << snapshot->analyticsOverhead * 100 << "%";
+
+            // Spread of steering work across workers
+            title << " - " << (snapshot->decomposed ? "regions" : "ranges") 
+                << " (D), imbalance: " << snapshot->steerImbalance;
+
+            // Distant chunks are simulated at a reduced rate
+            if (snapshot->chunked)
+                title << " - stepped: " << snapshot->steppedBoids 
+                    << ", chunks near: " << snapshot->nearChunks 
+                    << " / " << snapshot->totalChunks;
+
+            // Boids are steered over several steps under a budget
+            if (snapshot->steeringPhases > 1)
+                title << " - steering 1/" << snapshot->steeringPhases << " per step";
+
+            // Steps that can be scrubbed through
+            if (snapshot->recordingHistory)
+                title << " - history (R): " << snapshot->historyFirstStep 
+                    << " to " << snapshot->historyLastStep << ", "
+                    << snapshot->historyBytes / 1e6 << " MB"
+                    << (scrubbing ? ", scrubbing at " : ", at ") << snapshot->step;
+
+            // Volumetric flock, shown instead of the planar one
+            if (volumetric)
+                title << " - 3D (3): " << volume.boids.size() << " boids, step: "
+                    << volume.lastStepSeconds * 1000.0 << " ms, drawn: " 
+                    << volumeView.getDrawnCount() << ", order: " << volume.getPolarization();
+
+            // Trajectories written so far
+            if (snapshot->recordingTrajectory)
+                title << " - trajectory (V): " << snapshot->trajectoryBytes / 1e6 << " MB";
+
+            // Share of steering directions reused, in lazy mode
+            size_t lookups = snapshot->steeringHits + snapshot->steeringMisses;
+            if (snapshot->lazySteering && lookups != 0)
+                title << " - lazy hits: " 
+                    << 100.0 * snapshot->steeringHits / lookups << "%";
+
+            window.setTitle(title.str());
+        }
     }
 
+    // Stop simulating before tearing anything down
+    pipeline.stop();
+
+    // Finish writing whatever trajectory was being recorded
+    BoidManager::accessInstance().trajectory.close();
+
     // Free the boid texture and bg texture while still on the SFML OpenGL
     // context
     BoidManager::accessInstance().freeTexture();
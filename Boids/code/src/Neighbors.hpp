@@ -0,0 +1,320 @@
+#ifndef NEIGHBORS_HPP
+#define NEIGHBORS_HPP
+
+// For sorting gathered neighbors
+#include <algorithm>
+
+// For boids and their index
+#include "BoidWorld.hpp"
+
+// For distances
+#include "QuickMath.hpp"
+
+// For drawing samples
+#include "Random.hpp"
+
+// Neighbor sources for the steering kernels. Each calls visit(index,
+// distance) once for every neighbor of a boid
+
+// Every other boid within senseRadius, found by checking them all
+struct BruteForceNeighbors
+{
+    template <typename Visit>
+    static void forEach(const BoidWorld& world, size_t boid_index, 
+        SteeringContext&, Visit&& visit)
+    {
+        const BoidStorage& boids = world.boids;
+        const sf::Vector2f position = boids[boid_index].getPosition();
+        const double senseRadius = world.boids[boid_index].getSenseRadius(world);
+
+        for (size_t boidIter = 0; boidIter < boids.size(); ++boidIter)
+        {
+            // Don't consider itself as a neighbor
+            if (boidIter == boid_index)
+                continue;
+
+            // Only consider it if it doesn't exceed the maximum distance
+            // or is at least non-zero
+            double neighborDist = QuickMath::getMagnitude
+                (boids[boidIter].getPosition() - position);
+
+            if (neighborDist > senseRadius || neighborDist == 0)
+                continue;
+
+            visit(boidIter, neighborDist);
+        }
+    }
+};
+
+// Every other boid within senseRadius, found by checking only the grid
+// cells the radius overlaps
+struct GridNeighbors
+{
+    template <typename Visit>
+    static void forEach(const BoidWorld& world, size_t boid_index, 
+        SteeringContext&, Visit&& visit)
+    {
+        const UniformGrid& grid = world.grid;
+        const std::vector<uint32_t>& indices = grid.getSortedIndices();
+        const std::vector<sf::Vector2f>& points = grid.getSortedPoints();
+
+        const sf::Vector2f position = world.boids[boid_index].getPosition();
+        const double senseRadius = world.boids[boid_index].getSenseRadius(world);
+
+        const sf::Vector2f reach(senseRadius, senseRadius);
+
+        grid.forEachRowRun(position - reach, position + reach, [&](size_t first, size_t last)
+        {
+            size_t begin = grid.cellBegin(first), end = grid.cellEnd(last);
+            for (size_t sorted = begin; sorted < end; ++sorted)
+            {
+                if (indices[sorted] == boid_index)
+                    continue;
+
+                double neighborDist = QuickMath::getMagnitude(points[sorted] - position);
+                if (neighborDist > senseRadius || neighborDist == 0)
+                    continue;
+
+                visit(indices[sorted], neighborDist);
+            }
+        });
+    }
+};
+
+// Every other boid within senseRadius, found by checking only the hashed
+// cells the radius overlaps
+struct HashedNeighbors
+{
+    template <typename Visit>
+    static void forEach(const BoidWorld& world, size_t boid_index, 
+        SteeringContext& context, Visit&& visit)
+    {
+        const HashedGrid& grid = world.hashedGrid;
+        const std::vector<uint32_t>& indices = grid.getSortedIndices();
+        const std::vector<sf::Vector2f>& points = grid.getSortedPoints();
+
+        const sf::Vector2f position = world.boids[boid_index].getPosition();
+        const double senseRadius = world.boids[boid_index].getSenseRadius(world);
+
+        const int64_t firstColumn = grid.cellOf(position.x - senseRadius);
+        const int64_t lastColumn = grid.cellOf(position.x + senseRadius);
+        const int64_t firstRow = grid.cellOf(position.y - senseRadius);
+        const int64_t lastRow = grid.cellOf(position.y + senseRadius);
+
+        std::vector<uint32_t>& scanned = context.cellKeys;
+        scanned.clear();
+
+        for (int64_t row = firstRow; row <= lastRow; ++row)
+            for (int64_t column = firstColumn; column <= lastColumn; ++column)
+            {
+                // Cells whose keys collide share a run, only scan it once
+                uint32_t key = HashedGrid::hashCell(column, row);
+                if (std::find(scanned.begin(), scanned.end(), key) != scanned.end())
+                    continue;
+
+                scanned.push_back(key);
+
+                size_t begin, end;
+                grid.findKey(key, begin, end);
+
+                for (size_t sorted = begin; sorted < end; ++sorted)
+                {
+                    if (indices[sorted] == boid_index)
+                        continue;
+
+                    double neighborDist = QuickMath::getMagnitude(points[sorted] - position);
+                    if (neighborDist > senseRadius || neighborDist == 0)
+                        continue;
+
+                    visit(indices[sorted], neighborDist);
+                }
+            }
+    }
+};
+
+// Every other boid within senseRadius, found by checking only the 3x3
+// cells around the boid at the level of the grid hierarchy matching its
+// own radius, so near- and far-sighted boids each scan few cells
+struct HierarchyNeighbors
+{
+    template <typename Visit>
+    static void forEach(const BoidWorld& world, size_t boid_index, 
+        SteeringContext&, Visit&& visit)
+    {
+        const GridHierarchy& hierarchy = world.gridHierarchy;
+        const std::vector<uint32_t>& indices = hierarchy.getSortedIndices();
+        const std::vector<sf::Vector2f>& points = hierarchy.getSortedPoints();
+
+        const sf::Vector2f position = world.boids[boid_index].getPosition();
+        const double senseRadius = world.boids[boid_index].getSenseRadius(world);
+        const size_t level = hierarchy.levelFor(senseRadius);
+
+        const size_t firstColumn = hierarchy.columnOf(position.x - senseRadius, level);
+        const size_t lastColumn = hierarchy.columnOf(position.x + senseRadius, level);
+        const size_t firstRow = hierarchy.rowOf(position.y - senseRadius, level);
+        const size_t lastRow = hierarchy.rowOf(position.y + senseRadius, level);
+
+        auto scan = [&](size_t begin, size_t end)
+        {
+            for (size_t sorted = begin; sorted < end; ++sorted)
+            {
+                if (indices[sorted] == boid_index)
+                    continue;
+
+                double neighborDist = QuickMath::getMagnitude(points[sorted] - position);
+                if (neighborDist > senseRadius || neighborDist == 0)
+                    continue;
+
+                visit(indices[sorted], neighborDist);
+            }
+        };
+
+        for (size_t row = firstRow; row <= lastRow; ++row)
+        {
+            // Cells of a row are only contiguous where the Z-order curve
+            // runs along it, so runs are merged where they meet
+            size_t runBegin = hierarchy.cellBegin(firstColumn, row, level);
+            size_t runEnd = hierarchy.cellEnd(firstColumn, row, level);
+
+            for (size_t column = firstColumn + 1; column <= lastColumn; ++column)
+            {
+                size_t begin = hierarchy.cellBegin(column, row, level);
+                if (begin != runEnd)
+                {
+                    scan(runBegin, runEnd);
+                    runBegin = begin;
+                }
+
+                runEnd = hierarchy.cellEnd(column, row, level);
+            }
+
+            scan(runBegin, runEnd);
+        }
+    }
+};
+
+// The topologicalCount nearest boids within senseRadius, found through the
+// point quadtree, which only splits as deep as boids are crowded
+struct TopologicalNeighbors
+{
+    template <typename Visit>
+    static void forEach(const BoidWorld& world, size_t boid_index, 
+        SteeringContext& context, Visit&& visit)
+    {
+        const sf::Vector2f position = world.boids[boid_index].getPosition();
+        const float senseRadius = world.boids[boid_index].getSenseRadius(world);
+
+        std::vector<std::pair<float, uint32_t>>& nearest = context.nearest;
+        world.pointTree.findNearest(position, senseRadius, boid_index, 
+            world.topologicalCount, nearest);
+
+        for (const std::pair<float, uint32_t>& neighbor : nearest)
+            visit(neighbor.second, std::sqrt(neighbor.first));
+    }
+};
+
+// At most sampleCount boids within senseRadius, drawn uniformly with
+// replacement from the grid cells the radius overlaps. Every steering rule
+// averages over its neighbors, so a uniform sample needs no reweighting to
+// estimate the same averages. Draws are keyed by seed, step and boid id, so
+// they don't depend on which thread steers the boid
+struct SampledNeighbors
+{
+    template <typename Visit>
+    static void forEach(const BoidWorld& world, size_t boid_index, 
+        SteeringContext& context, Visit&& visit)
+    {
+        const UniformGrid& grid = world.grid;
+        const std::vector<uint32_t>& indices = grid.getSortedIndices();
+        const std::vector<sf::Vector2f>& points = grid.getSortedPoints();
+
+        const sf::Vector2f position = world.boids[boid_index].getPosition();
+        const double senseRadius = world.boids[boid_index].getSenseRadius(world);
+
+        const sf::Vector2f reach(senseRadius, senseRadius);
+
+        // Candidates come in one run per row
+        std::vector<std::pair<uint32_t, uint32_t>>& runs = context.sampledRuns;
+        runs.clear();
+
+        size_t candidates = 0;
+        grid.forEachRowRun(position - reach, position + reach, [&](size_t first, size_t last)
+        {
+            runs.emplace_back(grid.cellBegin(first), grid.cellEnd(last));
+            candidates += runs.back().second - runs.back().first;
+        });
+
+        auto consider = [&](size_t sorted)
+        {
+            if (indices[sorted] == boid_index)
+                return;
+
+            double neighborDist = QuickMath::getMagnitude(points[sorted] - position);
+            if (neighborDist > senseRadius || neighborDist == 0)
+                return;
+
+            visit(indices[sorted], neighborDist);
+        };
+
+        // Few enough to just check them all
+        if (candidates <= world.sampleCount)
+        {
+            for (const std::pair<uint32_t, uint32_t>& run : runs)
+                for (size_t sorted = run.first; sorted < run.second; ++sorted)
+                    consider(sorted);
+
+            return;
+        }
+
+        uint32_t stepKey = static_cast<uint32_t>(Random::philox(world.stepCount, world.seed));
+        Random::Stream stream(stepKey, world.boids.getId(boid_index));
+
+        for (size_t sample = 0; sample < world.sampleCount; ++sample)
+        {
+            // Find the run holding the drawn candidate
+            size_t drawn = stream.nextBelow(candidates);
+            size_t run = 0;
+            while (drawn >= runs[run].second - runs[run].first)
+            {
+                drawn -= runs[run].second - runs[run].first;
+                ++run;
+            }
+
+            consider(runs[run].first + drawn);
+        }
+    }
+};
+
+// Neighbors gathered by another source, visited by increasing index. Every
+// source shares this single visiting loop, and so a single instantiation of
+// the steering kernel, so sums come out bit-identical no matter the spatial
+// index, cell size or scan order that found the neighbors
+struct OrderedNeighbors
+{
+    // Fill the context's ordered neighbors from a source
+    template <typename Source>
+    static void gather(const BoidWorld& world, size_t boid_index, 
+        SteeringContext& context)
+    {
+        std::vector<std::pair<uint32_t, double>>& ordered = context.ordered;
+        ordered.clear();
+
+        Source::forEach(world, boid_index, context, 
+            [&ordered](size_t neighbor_index, double neighbor_dist)
+            {ordered.emplace_back(neighbor_index, neighbor_dist);});
+
+        std::sort(ordered.begin(), ordered.end());
+    }
+
+    template <typename Visit>
+    static void forEach(const BoidWorld& world, size_t boid_index, 
+        SteeringContext& context, Visit&& visit)
+    {
+        context.gatherNeighbors(world, boid_index, context);
+
+        for (const std::pair<uint32_t, double>& neighbor : context.ordered)
+            visit(neighbor.first, neighbor.second);
+    }
+};
+
+#endif
@@ -0,0 +1,33 @@
+#ifndef PLAY_RULES_HPP
+#define PLAY_RULES_HPP
+
+// For the worlds set up
+#include "BoidWorld.hpp"
+
+// Set the windowed simulation's play rules on a 2D or 3D world, so that
+// headless tools and benchmarks step the same flocking it shows
+template <typename World>
+void setPlayRules(World& world, float sense_radius)
+{
+    world.turnSpeed = 0.2;
+    world.flySpeed = 0.4;
+    world.senseRadius = sense_radius;
+    world.cohesionC = 1;
+    world.allignmentC = 2;
+    world.separationC = 1;
+}
+
+// Set up a headless 2D world over the given bounds under the play rules,
+// looked up through the grid and seeded, without analytics. Boids are
+// left for the caller to add, once any other setting is in place
+inline void setupHeadlessWorld(BoidWorld& world, const sf::FloatRect& world_bounds,
+    float sense_radius)
+{
+    world.setBounds(world_bounds);
+    setPlayRules(world, sense_radius);
+    world.spatialIndex = SpatialIndex::Grid;
+    world.analytics.interval = 0;
+    world.seed = 1;
+}
+
+#endif
@@ -0,0 +1,252 @@
+#include "PointQuadtree.hpp"
+
+// For Z-order keys
+#include "GridHierarchy.hpp"
+
+// For binary searches, bounds and the heap of nearest points
+#include <algorithm>
+
+// For cell coordinates
+#include <cmath>
+
+namespace
+{
+    // Levels below the root, each halving the width of cells
+    constexpr uint32_t depth = 16;
+
+    // Nodes holding no more points than this are scanned whole rather than
+    // split further
+    constexpr size_t leafSize = 24;
+}
+
+// Constructor
+
+PointQuadtree::PointQuadtree() :
+origin(0, 0), side(1)
+{}
+
+// Building
+
+void PointQuadtree::build(std::span<const sf::Vector2f> points)
+{
+    size_t pointCount = points.size();
+    this->sortedKeys.resize(pointCount);
+    this->sortedIndices.resize(pointCount);
+    this->scratchKeys.resize(pointCount);
+    this->scratchIndices.resize(pointCount);
+    this->sortedPoints.resize(pointCount);
+    this->nodes.clear();
+
+    if (pointCount == 0)
+        return;
+
+    // The root is the square around every point
+    sf::Vector2f lowest = points[0], highest = points[0];
+    for (const sf::Vector2f& point : points)
+    {
+        lowest.x = std::min(lowest.x, point.x);
+        lowest.y = std::min(lowest.y, point.y);
+        highest.x = std::max(highest.x, point.x);
+        highest.y = std::max(highest.y, point.y);
+    }
+
+    this->origin = lowest;
+    this->side = std::max({highest.x - lowest.x, highest.y - lowest.y, 1.0f});
+
+    const float cellsPerUnit = (1u << depth) / this->side;
+    auto cellOf = [&](float offset)
+    {
+        float cell = std::floor(offset * cellsPerUnit);
+        return static_cast<uint32_t>(std::clamp(cell, 0.f, (1u << depth) - 1.f));
+    };
+
+    for (size_t pointIter = 0; pointIter < pointCount; ++pointIter)
+    {
+        this->sortedKeys[pointIter] = GridHierarchy::interleave
+            (cellOf(points[pointIter].x - lowest.x), cellOf(points[pointIter].y - lowest.y));
+        this->sortedIndices[pointIter] = pointIter;
+    }
+
+    // Least significant digit radix sort over (key, index) pairs, a byte
+    // at a time, as the hashed grid does
+    for (int shift = 0; shift < 32; shift += 8)
+    {
+        size_t counts[256] = {};
+        for (uint32_t key : this->sortedKeys)
+            ++counts[(key >> shift) & 0xFF];
+
+        // A byte shared by every key doesn't reorder anything
+        if (counts[(this->sortedKeys[0] >> shift) & 0xFF] == pointCount)
+            continue;
+
+        size_t start = 0;
+        for (size_t& count : counts)
+        {
+            size_t bucket = count;
+            count = start;
+            start += bucket;
+        }
+
+        for (size_t pointIter = 0; pointIter < pointCount; ++pointIter)
+        {
+            uint32_t key = this->sortedKeys[pointIter];
+            size_t sorted = counts[(key >> shift) & 0xFF]++;
+
+            this->scratchKeys[sorted] = key;
+            this->scratchIndices[sorted] = this->sortedIndices[pointIter];
+        }
+
+        this->sortedKeys.swap(this->scratchKeys);
+        this->sortedIndices.swap(this->scratchIndices);
+    }
+
+    for (size_t sorted = 0; sorted < pointCount; ++sorted)
+        this->sortedPoints[sorted] = points[this->sortedIndices[sorted]];
+
+    // Nodes never outnumber points much, so reserving room for twice as
+    // many keeps their drifting count from reallocating while stepping
+    if (this->nodes.capacity() < pointCount + 1)
+        this->nodes.reserve(2 * pointCount + 1);
+
+    this->nodes.push_back({0, static_cast<uint32_t>(pointCount), 0});
+    this->split(0, depth);
+}
+
+void PointQuadtree::split(size_t node, uint32_t level)
+{
+    const uint32_t begin = this->nodes[node].begin, end = this->nodes[node].end;
+    if (level == 0 || end - begin <= leafSize)
+        return;
+
+    // Children split the node's keys in four, the column bit below the row
+    // bit, so a binary search finds where each one's points start
+    const uint32_t childLevel = level - 1;
+    const uint64_t childKeys = uint64_t(1) << (2 * childLevel);
+    const uint64_t firstKey = uint64_t(this->sortedKeys[begin]) >> (2 * level) << (2 * level);
+
+    const uint32_t firstChild = this->nodes.size();
+    this->nodes[node].firstChild = firstChild;
+
+    uint32_t childBegin = begin;
+    for (uint32_t child = 0; child < 4; ++child)
+    {
+        uint32_t childEnd = child == 3 ? end : std::lower_bound(this->sortedKeys.begin() 
+            + childBegin, this->sortedKeys.begin() + end, firstKey + (child + 1) * childKeys)
+            - this->sortedKeys.begin();
+
+        this->nodes.push_back({childBegin, childEnd, 0});
+        childBegin = childEnd;
+    }
+
+    for (uint32_t child = 0; child < 4; ++child)
+        this->split(firstChild + child, childLevel);
+}
+
+// Lookups
+
+void PointQuadtree::findNearest(sf::Vector2f position, float radius, uint32_t exclude_index,
+    size_t wanted, std::vector<std::pair<float, uint32_t>>& nearest) const
+{
+    nearest.clear();
+    if (wanted == 0 || this->nodes.empty())
+        return;
+
+    // While the radius fits within the child holding the position, its
+    // siblings can't hold anything, so go straight down to it. Squares are
+    // narrowed by a finest cell, as rounding while keying points could
+    // have put one right on an edge into a sibling
+    const float margin = this->side / (1u << depth);
+    size_t node = 0;
+    sf::Vector2f corner = this->origin;
+    float size = this->side;
+    while (this->nodes[node].firstChild != 0)
+    {
+        float half = size / 2;
+        uint32_t column = position.x >= corner.x + half, row = position.y >= corner.y + half;
+        sf::Vector2f childCorner(corner.x + column * half, corner.y + row * half);
+
+        if (position.x - radius - margin < childCorner.x 
+            || position.x + radius + margin > childCorner.x + half 
+            || position.y - radius - margin < childCorner.y 
+            || position.y + radius + margin > childCorner.y + half)
+            break;
+
+        node = this->nodes[node].firstChild + (column | row << 1);
+        corner = childCorner;
+        size = half;
+    }
+
+    this->search(node, corner, size, position, radius * radius, 
+        exclude_index, wanted, nearest);
+}
+
+void PointQuadtree::search(size_t node, sf::Vector2f corner, float size, sf::Vector2f position, 
+    float radius_squared, uint32_t exclude_index, size_t wanted, 
+    std::vector<std::pair<float, uint32_t>>& nearest) const
+{
+    const Node& current = this->nodes[node];
+    if (current.firstChild == 0)
+    {
+        for (size_t sorted = current.begin; sorted < current.end; ++sorted)
+        {
+            sf::Vector2f offset = this->sortedPoints[sorted] - position;
+            float distSquared = offset.x * offset.x + offset.y * offset.y;
+            uint32_t index = this->sortedIndices[sorted];
+
+            if (index == exclude_index || distSquared == 0 || distSquared > radius_squared)
+                continue;
+
+            // Keep only the closest ones, evicting the farthest kept
+            if (nearest.size() < wanted)
+            {
+                nearest.emplace_back(distSquared, index);
+                std::push_heap(nearest.begin(), nearest.end());
+            }
+
+            else if (std::make_pair(distSquared, index) < nearest.front())
+            {
+                std::pop_heap(nearest.begin(), nearest.end());
+                nearest.back() = std::make_pair(distSquared, index);
+                std::push_heap(nearest.begin(), nearest.end());
+            }
+        }
+
+        return;
+    }
+
+    // Squares are widened by a finest cell, so that rounding while keying
+    // points never hides one that sits right on an edge
+    const float margin = this->side / (1u << depth);
+    const float half = size / 2;
+
+    // Squared distance from the position to each child's square
+    float childDistances[4];
+    for (uint32_t child = 0; child < 4; ++child)
+    {
+        float left = corner.x + (child & 1) * half, top = corner.y + (child >> 1) * half;
+        float dx = std::max({left - margin - position.x, position.x - (left + half + margin), 0.f});
+        float dy = std::max({top - margin - position.y, position.y - (top + half + margin), 0.f});
+
+        childDistances[child] = dx * dx + dy * dy;
+    }
+
+    // The child holding the position first, then its neighbors and the one
+    // across, so that the heap fills with close points early and prunes
+    // the rest
+    const uint32_t holding = (position.x >= corner.x + half) 
+        | (position.y >= corner.y + half) << 1;
+
+    for (uint32_t child : {holding, holding ^ 1, holding ^ 2, holding ^ 3})
+    {
+        // A farther point can still win a tie on index, so only prune
+        // squares strictly beyond the farthest kept
+        const Node& next = this->nodes[current.firstChild + child];
+        float farthest = nearest.size() == wanted ? nearest.front().first : radius_squared;
+        if (next.begin == next.end || childDistances[child] > farthest)
+            continue;
+
+        this->search(current.firstChild + child, 
+            sf::Vector2f(corner.x + (child & 1) * half, corner.y + (child >> 1) * half), half, 
+            position, radius_squared, exclude_index, wanted, nearest);
+    }
+}
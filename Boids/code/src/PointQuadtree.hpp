@@ -0,0 +1,78 @@
+#ifndef POINT_QUADTREE_HPP
+#define POINT_QUADTREE_HPP
+
+// For positions
+#include <SFML/Graphics.hpp>
+
+// For fixed-width keys and indices
+#include <cstdint>
+
+// For the points to sort
+#include <span>
+
+// For the sorted elements and the heap of nearest points
+#include <utility>
+#include <vector>
+
+// Quadtree over the square around all points. Points are radix-sorted by
+// the Z-order key of their finest cell, so that every node covers a
+// contiguous range of them, and its children split that range in four.
+// Nodes are only split while they hold more than a few points, so a search
+// descends as deep as points are crowded, and scans about as many of them
+// however tightly they are packed. The finest cells are 1/65536 of the
+// square wide
+class PointQuadtree
+{
+    public:
+        // Default-construct an empty tree
+        PointQuadtree();
+
+        // Sort every point into the tree
+        void build(std::span<const sf::Vector2f> points);
+
+        // Find the wanted nearest points within radius of a position,
+        // leaving them as a max-heap of (squared distance, index) pairs.
+        // Points at distance zero and the excluded index are skipped, and
+        // ties go to the lower index, so the same points are found
+        // whatever order nodes are searched in
+        void findNearest(sf::Vector2f position, float radius, uint32_t exclude_index,
+            size_t wanted, std::vector<std::pair<float, uint32_t>>& nearest) const;
+
+    private:
+        // Range of the sorted points in a node, and where its four children
+        // start among the nodes, zero for leaves
+        struct Node
+        {
+            uint32_t begin;
+            uint32_t end;
+            uint32_t firstChild;
+        };
+
+        // Square covered by the root, and its side
+        sf::Vector2f origin;
+        float side;
+
+        std::vector<uint32_t> sortedKeys;
+        std::vector<uint32_t> sortedIndices;
+        std::vector<sf::Vector2f> sortedPoints;
+
+        // Ping-pong buffers for the radix sort passes
+        std::vector<uint32_t> scratchKeys;
+        std::vector<uint32_t> scratchIndices;
+
+        // Every node, the root first and siblings next to each other
+        std::vector<Node> nodes;
+
+        // Split a node whose keys share all but the lowest 2 * level bits,
+        // and its children in turn, while they hold more than a few points
+        void split(size_t node, uint32_t level);
+
+        // Search a node whose square starts at corner and is size wide,
+        // skipping children whose square lies beyond the farthest point
+        // kept
+        void search(size_t node, sf::Vector2f corner, float size, sf::Vector2f position, 
+            float radius_squared, uint32_t exclude_index, size_t wanted, 
+            std::vector<std::pair<float, uint32_t>>& nearest) const;
+};
+
+#endif
@@ -7,6 +7,9 @@
 // For other goodies, and constantes
 #include <numbers>
 
+// For square roots, powers and arc tangents
+#include <cmath>
+
 namespace QuickMath
 {
     // Get vector magnitude
@@ -26,6 +29,32 @@ namespace QuickMath
         return sf::Vector2<T>(vec.x / magnitude, vec.y / magnitude);
     }
 
+    // Get 3D vector magnitude
+    template <typename T>
+    inline double getMagnitude(const sf::Vector3<T>& vec)
+    {return std::sqrt(double(vec.x) * vec.x + double(vec.y) * vec.y + double(vec.z) * vec.z);}
+
+    // Get 3D vector as itself normalized, or a null vector if null
+    template <typename T>
+    sf::Vector3<T> getNormalized(const sf::Vector3<T>& vec)
+    {
+        double magnitude = getMagnitude(vec);
+        if (magnitude == 0)
+            return vec;
+
+        return sf::Vector3<T>(vec.x / magnitude, vec.y / magnitude, vec.z / magnitude);
+    }
+
+    // Get the dot product of two 3D vectors
+    template <typename T>
+    inline T dotProduct(const sf::Vector3<T>& a, const sf::Vector3<T>& b)
+    {return a.x * b.x + a.y * b.y + a.z * b.z;}
+
+    // Get the cross product of two 3D vectors
+    template <typename T>
+    inline sf::Vector3<T> crossProduct(const sf::Vector3<T>& a, const sf::Vector3<T>& b)
+    {return sf::Vector3<T>(a.y * b.z - a.z * b.y, a.z * b.x - a.x * b.z, a.x * b.y - a.y * b.x);}
+
     // Get the remainder of a value between a range
     template <typename T>
     T modulus(T val, const T& min, const T& max)
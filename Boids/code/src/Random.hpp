@@ -0,0 +1,80 @@
+#ifndef RANDOM_HPP
+#define RANDOM_HPP
+
+// For fixed-width integers
+#include <cstdint>
+
+// Counter-based random numbers. Every value is a pure function of a key and
+// a counter, so results don't depend on call order, thread count or
+// platform, and any number of independent streams can be split off a seed
+namespace Random
+{
+    // Philox-2x32-10: a keyed bijection over 64-bit counters with good
+    // statistical quality. Get 64 random bits for a counter under a key
+    inline uint64_t philox(uint64_t counter, uint32_t key)
+    {
+        uint32_t low = static_cast<uint32_t>(counter);
+        uint32_t high = static_cast<uint32_t>(counter >> 32);
+
+        for (int round = 0; round < 10; ++round)
+        {
+            uint64_t product = static_cast<uint64_t>(0xD256D193u) * low;
+            low = static_cast<uint32_t>(product >> 32) ^ key ^ high;
+            high = static_cast<uint32_t>(product);
+            key += 0x9E3779B9u;
+        }
+
+        return static_cast<uint64_t>(high) << 32 | low;
+    }
+
+    // Get a float uniformly distributed in [0, 1) from 32 random bits
+    inline float unitFloat(uint32_t bits)
+    {return (bits >> 8) * (1.f / 16777216.f);}
+
+    // Get a float uniformly distributed in [min, max) from 32 random bits
+    inline float uniform(uint32_t bits, float min, float max)
+    {return min + unitFloat(bits) * (max - min);}
+
+    // Sequential generator over its own slice of the counter space. Streams
+    // with different ids never overlap, so each thread can own one
+    class Stream
+    {
+        public:
+            Stream(uint32_t seed, uint32_t stream_id) :
+            key(seed), counter(static_cast<uint64_t>(stream_id) << 32),
+            buffered(0), hasBuffered(false)
+            {}
+
+            // Get the next 32 random bits
+            uint32_t next()
+            {
+                // Every counter yields two values, hand out both
+                if (hasBuffered)
+                {
+                    hasBuffered = false;
+                    return buffered;
+                }
+
+                uint64_t bits = philox(counter++, key);
+                buffered = static_cast<uint32_t>(bits >> 32);
+                hasBuffered = true;
+                return static_cast<uint32_t>(bits);
+            }
+
+            // Get a float uniformly distributed in [0, 1)
+            float nextUnit()
+            {return unitFloat(next());}
+
+            // Get an integer uniformly distributed in [0, bound), bound > 0
+            uint32_t nextBelow(uint32_t bound)
+            {return static_cast<uint32_t>((static_cast<uint64_t>(next()) * bound) >> 32);}
+
+        private:
+            uint32_t key;
+            uint64_t counter;
+            uint32_t buffered;
+            bool hasBuffered;
+    };
+}
+
+#endif
@@ -0,0 +1,338 @@
+#include "ScalingBenchmark.hpp"
+
+// For sorting step times
+#include <algorithm>
+
+// For timing steps
+#include <chrono>
+
+// For world sizes
+#include <cmath>
+
+// For looking variants up by name
+#include <iterator>
+
+// For JSON files
+#include <fstream>
+#include <sstream>
+
+// For the simulated worlds, under the play rules
+#include "BoidWorld.hpp"
+#include "PlayRules.hpp"
+
+// For steady-state allocations
+#include "AllocationCounter.hpp"
+
+// For peak memory
+#ifdef _WIN32
+    #include <windows.h>
+    #include <psapi.h>
+#else
+    #include <sys/resource.h>
+#endif
+
+// Constructor
+
+ScalingBenchmark::ScalingBenchmark() :
+boidCounts{1000, 10000, 100000, 1000000}, densities{2, 10}, threadCounts{1, 4},
+variants{BenchmarkVariant::Analytics, BenchmarkVariant::Topological, 
+    BenchmarkVariant::Sampled, BenchmarkVariant::HashedGrid, BenchmarkVariant::Hierarchy, 
+    BenchmarkVariant::LazySteering, BenchmarkVariant::Chunked, BenchmarkVariant::Deterministic,
+    BenchmarkVariant::ClusteredTopological, BenchmarkVariant::Regions},
+variantBoidCount(10000), variantDensity(10), variantThreadCount(4),
+maxBoidCount(SIZE_MAX), warmupSteps(3), minSteps(10), secondsPerCase(2),
+seed(1), senseRadius(40), deterministic(false)
+{}
+
+// Variant names, in declaration order
+static const char* const variantNames[] = 
+    {"plain", "analytics", "topological", "sampled", "hashedGrid", "hierarchy", 
+    "lazySteering", "chunked", "deterministic", "clusteredTopological",
+    "regions"};
+
+// Sweep expansion
+
+// Get how a thread count reads in case names. Hardware-dependent counts
+// are named as such, so the same baseline applies on any machine
+static std::string getThreadsName(size_t thread_count)
+{return thread_count == 0 ? "allThreads" : std::to_string(thread_count) + "threads";}
+
+std::vector<BenchmarkCase> ScalingBenchmark::buildCases() const
+{
+    std::vector<BenchmarkCase> cases;
+
+    for (size_t boidCount : boidCounts)
+    for (float density : densities)
+    for (size_t threadCount : threadCounts)
+    {
+        if (boidCount > maxBoidCount)
+            continue;
+
+        std::ostringstream name;
+        name << "boids" << boidCount << "-density" << density << "-"
+            << getThreadsName(threadCount) << (deterministic ? "-deterministic" : "");
+
+        cases.push_back({name.str(), boidCount, density, threadCount, BenchmarkVariant::Plain});
+    }
+
+    for (BenchmarkVariant variant : variants)
+    {
+        if (variantBoidCount > maxBoidCount)
+            continue;
+
+        std::ostringstream name;
+        name << "boids" << variantBoidCount << "-density" << variantDensity << "-"
+            << getThreadsName(variantThreadCount) << "-" << getVariantName(variant)
+            << (deterministic ? "-deterministic" : "");
+
+        cases.push_back({name.str(), variantBoidCount, variantDensity, 
+            variantThreadCount, variant});
+    }
+
+    return cases;
+}
+
+// Running
+
+BenchmarkResult ScalingBenchmark::run(const BenchmarkCase& bench_case) const
+{
+    // Square world holding the requested density, with the windowed
+    // simulation's play rules
+    float side = std::sqrt(bench_case.boidCount / bench_case.density) * 100;
+
+    BoidWorld world;
+    setupHeadlessWorld(world, sf::FloatRect(0, 0, side, side), senseRadius);
+    world.deterministic = deterministic;
+
+    switch (bench_case.variant)
+    {
+        case BenchmarkVariant::Plain:
+            break;
+
+        case BenchmarkVariant::Analytics:
+            world.analytics.interval = 10;
+            break;
+
+        case BenchmarkVariant::Topological:
+            world.neighborMode = NeighborMode::Topological;
+            break;
+
+        case BenchmarkVariant::Sampled:
+            world.neighborMode = NeighborMode::Sampled;
+            break;
+
+        case BenchmarkVariant::HashedGrid:
+            world.spatialIndex = SpatialIndex::HashedGrid;
+            break;
+
+        case BenchmarkVariant::Hierarchy:
+            world.spatialIndex = SpatialIndex::Hierarchical;
+            break;
+
+        case BenchmarkVariant::LazySteering:
+            world.lazySteering = true;
+            break;
+
+        case BenchmarkVariant::Chunked:
+            world.chunks.enabled = true;
+            world.chunks.setInterest(sf::FloatRect(0, 0, side / 2, side / 2));
+            break;
+
+        case BenchmarkVariant::Deterministic:
+            world.deterministic = true;
+            break;
+
+        case BenchmarkVariant::ClusteredTopological:
+            world.neighborMode = NeighborMode::Topological;
+            break;
+
+        case BenchmarkVariant::Regions:
+            world.decomposition.enabled = true;
+            break;
+    }
+
+    world.setThreadCount(bench_case.threadCount);
+    world.seed = seed;
+    world.setBoidCount(bench_case.boidCount);
+
+    if (bench_case.variant == BenchmarkVariant::ClusteredTopological)
+        for (size_t boidIter = 0; boidIter < bench_case.boidCount; ++boidIter)
+            world.boids[boidIter].setPosition(world.boids[boidIter].getPosition() / 8.f);
+
+    for (size_t stepIter = 0; stepIter < warmupSteps; ++stepIter)
+        world.update();
+
+    // Step until both the step minimum and the time budget are met. Only
+    // steps themselves count toward allocations, not keeping their times
+    std::vector<double> stepMs;
+    double totalSeconds = 0;
+    size_t allocations = 0;
+    while (stepMs.size() < minSteps || totalSeconds < secondsPerCase)
+    {
+        size_t allocationsBefore = AllocationCounter::getCount();
+        auto start = std::chrono::steady_clock::now();
+        world.update();
+        auto end = std::chrono::steady_clock::now();
+        allocations += AllocationCounter::getCount() - allocationsBefore;
+
+        double seconds = std::chrono::duration<double>(end - start).count();
+        stepMs.push_back(seconds * 1000.0);
+        totalSeconds += seconds;
+    }
+
+    BenchmarkResult result;
+    result.benchCase = bench_case;
+    result.steps = stepMs.size();
+    result.stepsPerSecond = stepMs.size() / totalSeconds;
+
+    std::sort(stepMs.begin(), stepMs.end());
+    result.p50Ms = stepMs[stepMs.size() / 2];
+    result.p99Ms = stepMs[std::min(stepMs.size() - 1, stepMs.size() * 99 / 100)];
+    result.peakRssMb = getPeakRssMb();
+    result.allocations = allocations;
+
+    return result;
+}
+
+// Output
+
+bool ScalingBenchmark::writeJson(const std::string& json_path,
+    const std::vector<BenchmarkResult>& results)
+{
+    std::ofstream json(json_path);
+    if (!json)
+        return false;
+
+    json << "{\n  \"cases\": [\n";
+    for (size_t resultIter = 0; resultIter < results.size(); ++resultIter)
+    {
+        const BenchmarkResult& result = results[resultIter];
+        json << "    {\"name\": \"" << result.benchCase.name << "\""
+            << ", \"boids\": " << result.benchCase.boidCount
+            << ", \"density\": " << result.benchCase.density
+            << ", \"threads\": " << result.benchCase.threadCount
+            << ", \"variant\": \"" << getVariantName(result.benchCase.variant) << "\""
+            << ", \"steps\": " << result.steps
+            << ", \"stepsPerSecond\": " << result.stepsPerSecond
+            << ", \"p50Ms\": " << result.p50Ms
+            << ", \"p99Ms\": " << result.p99Ms
+            << ", \"peakRssMb\": " << result.peakRssMb
+            << ", \"allocations\": " << result.allocations << "}"
+            << (resultIter + 1 < results.size() ? ",\n" : "\n");
+    }
+    json << "  ]\n}\n";
+
+    return static_cast<bool>(json);
+}
+
+// Get the value following "key": within a line, empty if there is none
+static std::string readField(const std::string& line, const std::string& key)
+{
+    size_t keyAt = line.find("\"" + key + "\"");
+    if (keyAt == std::string::npos)
+        return "";
+
+    size_t valueAt = line.find_first_not_of(" :", keyAt + key.size() + 2);
+    if (valueAt == std::string::npos)
+        return "";
+
+    if (line[valueAt] == '"')
+        return line.substr(valueAt + 1, line.find('"', valueAt + 1) - valueAt - 1);
+
+    return line.substr(valueAt, line.find_first_of(",}", valueAt) - valueAt);
+}
+
+bool ScalingBenchmark::readJson(const std::string& json_path,
+    std::vector<BenchmarkResult>& results)
+{
+    std::ifstream json(json_path);
+    if (!json)
+        return false;
+
+    // Only files laid out by writeJson are understood: one case per line
+    std::string line;
+    while (std::getline(json, line))
+    {
+        std::string name = readField(line, "name");
+        if (name.empty())
+            continue;
+
+        BenchmarkResult result;
+        result.benchCase.name = name;
+        result.benchCase.boidCount = std::stoul(readField(line, "boids"));
+        result.benchCase.density = std::stof(readField(line, "density"));
+        result.benchCase.threadCount = std::stoul(readField(line, "threads"));
+
+        // Older files predate variants, holding plain cases only
+        std::string variant = readField(line, "variant");
+        auto variantName = std::find_if(std::begin(variantNames), std::end(variantNames),
+            [&variant](const char* name) {return variant == name;});
+        result.benchCase.variant = variantName == std::end(variantNames) ? BenchmarkVariant::Plain
+            : static_cast<BenchmarkVariant>(variantName - std::begin(variantNames));
+        result.steps = std::stoul(readField(line, "steps"));
+        result.stepsPerSecond = std::stod(readField(line, "stepsPerSecond"));
+        result.p50Ms = std::stod(readField(line, "p50Ms"));
+        result.p99Ms = std::stod(readField(line, "p99Ms"));
+        result.peakRssMb = std::stod(readField(line, "peakRssMb"));
+
+        // Older files predate allocation counts
+        std::string allocations = readField(line, "allocations");
+        result.allocations = allocations.empty() ? 0 : std::stoul(allocations);
+
+        results.push_back(result);
+    }
+
+    return true;
+}
+
+// Comparison
+
+std::vector<BenchmarkRegression> ScalingBenchmark::compare
+    (const std::vector<BenchmarkResult>& baseline,
+    const std::vector<BenchmarkResult>& results, double threshold)
+{
+    std::vector<BenchmarkRegression> regressions;
+
+    for (const BenchmarkResult& result : results)
+    {
+        auto reference = std::find_if(baseline.begin(), baseline.end(),
+            [&result](const BenchmarkResult& base)
+            {return base.benchCase.name == result.benchCase.name;});
+
+        // Medians, unlike averages, don't move with the odd step stalled
+        // by the rest of the machine
+        if (reference == baseline.end())
+            regressions.push_back({result.benchCase.name, true, 0, result.p50Ms});
+
+        else if (result.p50Ms > reference->p50Ms * (1 + threshold))
+            regressions.push_back({result.benchCase.name, false,
+                reference->p50Ms, result.p50Ms});
+    }
+
+    return regressions;
+}
+
+// Names
+
+const char* ScalingBenchmark::getVariantName(BenchmarkVariant variant)
+{return variantNames[static_cast<size_t>(variant)];}
+
+// Memory
+
+double ScalingBenchmark::getPeakRssMb()
+{
+#ifdef _WIN32
+    PROCESS_MEMORY_COUNTERS counters;
+    if (!K32GetProcessMemoryInfo(GetCurrentProcess(), &counters, sizeof(counters)))
+        return 0;
+
+    return counters.PeakWorkingSetSize / 1e6;
+#else
+    // Reported in kilobytes
+    rusage usage;
+    if (getrusage(RUSAGE_SELF, &usage) != 0)
+        return 0;
+
+    return usage.ru_maxrss / 1e3;
+#endif
+}
@@ -0,0 +1,161 @@
+#ifndef SCALING_BENCHMARK_HPP
+#define SCALING_BENCHMARK_HPP
+
+// For case names and results
+#include <string>
+#include <vector>
+
+// World settings a case runs under, on top of the plain metric flock
+// looked up through the grid index
+enum class BenchmarkVariant
+{
+    Plain,
+
+    // Flock analytics gathered every tenth step
+    Analytics,
+
+    // Other neighbor modes
+    Topological,
+    Sampled,
+
+    // Other spatial indexes
+    HashedGrid,
+    Hierarchy,
+
+    // Desired directions reused while neighborhoods barely change
+    LazySteering,
+
+    // Distant chunks stepped at a reduced rate, with a quarter of the
+    // world of interest
+    Chunked,
+
+    // Neighbors visited in index order, for bit-identical steps
+    Deterministic,
+
+    // Topological neighbors with every boid packed into an eighth of the
+    // world's width and height, far denser than the world on average
+    ClusteredTopological,
+
+    // Steering split into regions of the grid cut for even work
+    Regions
+};
+
+// A single headless configuration to time
+struct BenchmarkCase
+{
+    // Stable across machines, so results can be matched to baselines
+    std::string name;
+
+    size_t boidCount;
+
+    // Boids per 100x100 px of world, which sets the world's size
+    float density;
+
+    // Zero means one per hardware thread
+    size_t threadCount;
+
+    BenchmarkVariant variant;
+};
+
+// Timings of a finished case
+struct BenchmarkResult
+{
+    BenchmarkCase benchCase;
+
+    size_t steps;
+    double stepsPerSecond;
+
+    // Median and 99th percentile of the step durations
+    double p50Ms;
+    double p99Ms;
+
+    // Peak resident memory of the process after the case, which is that
+    // of the case alone when run in a process of its own
+    double peakRssMb;
+
+    // Heap allocations made by the timed steps, as counted through
+    // AllocationCounter. Warmed-up worlds are expected to make none
+    size_t allocations;
+};
+
+// A case whose median step got slower than its baseline allows, or has no
+// baseline
+struct BenchmarkRegression
+{
+    std::string name;
+    bool missing;
+    double baselineP50Ms;
+    double p50Ms;
+};
+
+// Sweeps boid count, density and thread count over seeded, headless worlds
+// stepped through the grid index, timing every step. Other world settings
+// are covered by variant cases of a single size
+class ScalingBenchmark
+{
+    public:
+        // Values swept over. Every combination becomes a case. Thread
+        // counts are fixed rather than following the hardware, so that a
+        // baseline recorded on a small machine still times the pool
+        std::vector<size_t> boidCounts;
+        std::vector<float> densities;
+        std::vector<size_t> threadCounts;
+
+        // Variants timed on top of the sweep, each as a single case of
+        // variantBoidCount boids at variantDensity on variantThreadCount
+        // threads
+        std::vector<BenchmarkVariant> variants;
+        size_t variantBoidCount;
+        float variantDensity;
+        size_t variantThreadCount;
+
+        // Cases with more boids than this are skipped
+        size_t maxBoidCount;
+
+        // Untimed steps before measuring, and the timing budget per case.
+        // Every case is timed for at least minSteps regardless
+        size_t warmupSteps;
+        size_t minSteps;
+        double secondsPerCase;
+
+        // Seed and play rules shared by every case
+        unsigned seed;
+        float senseRadius;
+
+        // Step every case in deterministic mode, named apart from the rest
+        bool deterministic;
+
+        // Default-construct the standard suite, from 1k to 1M boids
+        ScalingBenchmark();
+
+        // Expand the sweep into one entry per case
+        std::vector<BenchmarkCase> buildCases() const;
+
+        // Time a single case
+        BenchmarkResult run(const BenchmarkCase& bench_case) const;
+
+        // Write results as JSON, one case per line. False if the file
+        // couldn't be written
+        static bool writeJson(const std::string& json_path,
+            const std::vector<BenchmarkResult>& results);
+
+        // Read results back from a file written by writeJson. False if the
+        // file couldn't be read
+        static bool readJson(const std::string& json_path,
+            std::vector<BenchmarkResult>& results);
+
+        // Get the cases whose median step got slower by more than the
+        // given fraction of their baseline's, and those missing from the
+        // baseline. Baseline cases that weren't run are fine
+        static std::vector<BenchmarkRegression> compare
+            (const std::vector<BenchmarkResult>& baseline,
+            const std::vector<BenchmarkResult>& results, double threshold);
+
+        // Get the peak resident memory of the process so far, in MB
+        static double getPeakRssMb();
+
+        // Get the name a variant goes by in case names and JSON files
+        static const char* getVariantName(BenchmarkVariant variant);
+};
+
+#endif
@@ -0,0 +1,50 @@
+#include "ScratchArena.hpp"
+
+// Constructor
+
+ScratchArena::ScratchArena() :
+blockBytes(0), usedBytes(0), spilledBytes(0)
+{}
+
+// Allocation
+
+void* ScratchArena::allocateBytes(size_t bytes, size_t alignment)
+{
+    // Blocks come aligned for any type, so aligning offsets is enough
+    size_t offset = (this->usedBytes + alignment - 1) / alignment * alignment;
+    if (offset + bytes <= this->blockBytes)
+    {
+        this->usedBytes = offset + bytes;
+        return this->block.get() + offset;
+    }
+
+    // Keep going in a block of its own until the next reset
+    this->spills.emplace_back(new std::byte[bytes + alignment]);
+    this->spilledBytes += bytes + alignment;
+
+    void* spilled = this->spills.back().get();
+    size_t room = bytes + alignment;
+    return std::align(alignment, bytes, spilled, room);
+}
+
+void ScratchArena::reset()
+{
+    if (!this->spills.empty())
+    {
+        this->blockBytes += this->spilledBytes;
+        this->block.reset(new std::byte[this->blockBytes]);
+
+        this->spills.clear();
+        this->spilledBytes = 0;
+    }
+
+    this->usedBytes = 0;
+}
+
+// Getters
+
+size_t ScratchArena::getCapacityBytes() const
+{return this->blockBytes;}
+
+size_t ScratchArena::getUsedBytes() const
+{return this->usedBytes;}
@@ -0,0 +1,64 @@
+#ifndef SCRATCH_ARENA_HPP
+#define SCRATCH_ARENA_HPP
+
+// For blocks
+#include <cstddef>
+#include <memory>
+#include <vector>
+
+// For handing buffers out
+#include <span>
+
+// For restricting buffers to types that need no destruction
+#include <type_traits>
+
+// Linear allocator for buffers that only live through one step. Buffers are
+// carved one after the other out of a single block, and reset() hands the
+// whole block back at once. A step that outgrows the block spills into
+// extra blocks, which the next reset() replaces with a single one large
+// enough for all of it, so steps that need no more than earlier ones
+// allocate nothing
+class ScratchArena
+{
+    public:
+        // Default-construct without any block
+        ScratchArena();
+
+        // Forbid any copy-construction or copy-assignment
+        ScratchArena(ScratchArena const&) = delete;
+        ScratchArena& operator=(ScratchArena const&) = delete;
+
+        // Get an uninitialized buffer of the given amount of elements, valid
+        // until the next reset
+        template <typename T>
+        std::span<T> allocate(size_t count)
+        {
+            static_assert(std::is_trivially_destructible_v<T>,
+                "Buffers are released without being destroyed");
+
+            return std::span<T>(static_cast<T*>
+                (this->allocateBytes(count * sizeof(T), alignof(T))), count);
+        }
+
+        // Release every buffer, growing the block if the latest step spilled
+        void reset();
+
+        // Get the size of the block, and the bytes handed out since the
+        // latest reset
+        size_t getCapacityBytes() const;
+        size_t getUsedBytes() const;
+
+    private:
+        std::unique_ptr<std::byte[]> block;
+        size_t blockBytes;
+        size_t usedBytes;
+
+        // Blocks taken past the main one since the latest reset
+        std::vector<std::unique_ptr<std::byte[]>> spills;
+        size_t spilledBytes;
+
+        // Get aligned room for the given amount of bytes
+        void* allocateBytes(size_t bytes, size_t alignment);
+};
+
+#endif
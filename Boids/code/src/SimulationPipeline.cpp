@@ -0,0 +1,88 @@
+#include "SimulationPipeline.hpp"
+
+// Constructor & Destructor
+
+SimulationPipeline::SimulationPipeline(BoidWorld& simulated_world) :
+world(simulated_world), running(false), unfetched(false)
+{}
+
+SimulationPipeline::~SimulationPipeline()
+{
+    this->stop();
+}
+
+SimulationPipeline::Pause::Pause(SimulationPipeline& paused_pipeline) :
+pipeline(paused_pipeline), wasRunning(paused_pipeline.isRunning())
+{
+    this->pipeline.stop();
+}
+
+SimulationPipeline::Pause::~Pause()
+{
+    if (this->wasRunning)
+        this->pipeline.start();
+}
+
+// Thread control
+
+void SimulationPipeline::start()
+{
+    if (this->isRunning())
+        return;
+
+    this->running = true;
+    this->simulationThread = std::thread(&SimulationPipeline::simulate, this);
+}
+
+void SimulationPipeline::stop()
+{
+    {
+        std::lock_guard<std::mutex> lock(this->handOffMutex);
+        this->running = false;
+    }
+    this->fetched.notify_one();
+
+    if (this->simulationThread.joinable())
+        this->simulationThread.join();
+}
+
+bool SimulationPipeline::isRunning() const
+{return this->running;}
+
+// Snapshot hand-off
+
+bool SimulationPipeline::fetch()
+{
+    bool changed;
+    {
+        std::lock_guard<std::mutex> lock(this->handOffMutex);
+        changed = this->snapshots.fetch();
+        if (changed)
+            this->unfetched = false;
+    }
+
+    if (changed)
+        this->fetched.notify_one();
+
+    return changed;
+}
+
+const BoidSnapshot& SimulationPipeline::latest() const
+{return this->snapshots.front();}
+
+void SimulationPipeline::simulate()
+{
+    while (this->running)
+    {
+        this->world.update();
+        this->world.captureSnapshot(this->snapshots.back());
+
+        // Hold the step back until the frame took the previous one. A stop
+        // still publishes it, as the world already moved on to it
+        std::unique_lock<std::mutex> lock(this->handOffMutex);
+        this->fetched.wait(lock, [this]{return !this->unfetched || !this->running;});
+
+        this->snapshots.publish();
+        this->unfetched = true;
+    }
+}
@@ -0,0 +1,81 @@
+#ifndef SIMULATION_PIPELINE_HPP
+#define SIMULATION_PIPELINE_HPP
+
+// For the simulation thread
+#include <atomic>
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+
+// For the world being stepped
+#include "BoidWorld.hpp"
+
+// For the hand-off to rendering
+#include "BoidSnapshot.hpp"
+#include "TripleBuffer.hpp"
+
+// Steps a world on its own thread, publishing a snapshot after every step,
+// so that rendering one step overlaps with simulating the next. A step is
+// only published once the previous one was fetched, so the world advances
+// one step per drawn frame, as it does when stepped in lockstep
+class SimulationPipeline
+{
+    public:
+        // Keeps the pipeline stopped for as long as it lives, so that the
+        // world can be edited, then resumes it if it was running
+        class Pause
+        {
+            public:
+                explicit Pause(SimulationPipeline& paused_pipeline);
+                ~Pause();
+
+            private:
+                SimulationPipeline& pipeline;
+                bool wasRunning;
+        };
+
+        // Bind to a world. Nothing runs until started
+        explicit SimulationPipeline(BoidWorld& simulated_world);
+
+        // Forbid any copy-construction or copy-assignment
+        SimulationPipeline(SimulationPipeline const&) = delete;
+        SimulationPipeline& operator=(SimulationPipeline const&) = delete;
+
+        // Stop the simulation thread, if running
+        ~SimulationPipeline();
+
+        // Start stepping. The world must not be touched by anyone else
+        // until stopped
+        void start();
+
+        // Finish the current step and join the simulation thread
+        void stop();
+
+        // Check whether the simulation thread is running
+        bool isRunning() const;
+
+        // Take over the latest snapshot, if a new one was published,
+        // letting the next step through. True if the latest snapshot changed
+        bool fetch();
+
+        // Get the latest fetched snapshot
+        const BoidSnapshot& latest() const;
+
+    private:
+        BoidWorld& world;
+        TripleBuffer<BoidSnapshot> snapshots;
+
+        std::thread simulationThread;
+        std::atomic<bool> running;
+
+        // Whether a published snapshot is still waiting to be fetched,
+        // signalled when it is or when stopping
+        bool unfetched;
+        std::mutex handOffMutex;
+        std::condition_variable fetched;
+
+        // Simulation thread loop
+        void simulate();
+};
+
+#endif
@@ -0,0 +1,134 @@
+#include "SpatialDecomposition.hpp"
+
+// For busiest workers
+#include <algorithm>
+
+// Constructor
+
+SpatialDecomposition::SpatialDecomposition() :
+enabled(false), rebalanceInterval(30), imbalanceThreshold(1.15),
+columns(0), rows(0), lastBalancedStep(0), rebalanceCount(0)
+{}
+
+// Balancing
+
+void SpatialDecomposition::prepare(const UniformGrid& grid, size_t region_count, 
+    size_t step, double imbalance)
+{
+    bool layoutChanged = regions.size() != region_count 
+        || columns != grid.getColumns() || rows != grid.getRows();
+
+    bool checkDue = step >= lastBalancedStep + rebalanceInterval;
+
+    if (layoutChanged || (checkDue && imbalance > imbalanceThreshold))
+    {
+        this->bisect(grid, region_count);
+        lastBalancedStep = step;
+    }
+
+    // Checked but balanced enough, check again later
+    else if (checkDue)
+        lastBalancedStep = step;
+}
+
+void SpatialDecomposition::bisect(const UniformGrid& grid, size_t region_count)
+{
+    columns = grid.getColumns();
+    rows = grid.getRows();
+
+    // Every boid of a cell visits the boids of the 3x3 cells around it
+    cellWeights.assign(columns * rows, 0);
+    for (size_t row = 0; row < rows; ++row)
+        for (size_t column = 0; column < columns; ++column)
+        {
+            size_t cell = row * columns + column;
+            double boids = grid.cellEnd(cell) - grid.cellBegin(cell);
+            if (boids == 0)
+                continue;
+
+            double around = 0;
+            for (size_t aroundRow = row == 0 ? 0 : row - 1; 
+                aroundRow <= std::min(row + 1, rows - 1); ++aroundRow)
+                for (size_t aroundColumn = column == 0 ? 0 : column - 1; 
+                    aroundColumn <= std::min(column + 1, columns - 1); ++aroundColumn)
+                {
+                    size_t aroundCell = aroundRow * columns + aroundColumn;
+                    around += grid.cellEnd(aroundCell) - grid.cellBegin(aroundCell);
+                }
+
+            cellWeights[cell] = boids * around;
+        }
+
+    regions.clear();
+    this->split({0, columns - 1, 0, rows - 1}, region_count);
+    ++rebalanceCount;
+}
+
+void SpatialDecomposition::split(const Region& area, size_t parts)
+{
+    if (parts == 0)
+        return;
+
+    bool empty = area.lastColumn < area.firstColumn || area.lastRow < area.firstRow;
+    size_t width = empty ? 0 : area.lastColumn - area.firstColumn + 1;
+    size_t height = empty ? 0 : area.lastRow - area.firstRow + 1;
+
+    // A single cell can't be cut any further, so the other parts go empty
+    if (parts == 1 || width * height <= 1)
+    {
+        regions.push_back(area);
+        for (size_t part = 1; part < parts; ++part)
+            regions.push_back({1, 0, 1, 0});
+
+        return;
+    }
+
+    // Work along the longer side, one slice at a time
+    bool byColumns = width >= height;
+    size_t slices = byColumns ? width : height;
+
+    // Slice weights are only needed until the cut is found, so the
+    // recursive splits below can reuse them
+    sliceWeights.assign(slices, 0);
+    for (size_t row = area.firstRow; row <= area.lastRow; ++row)
+        for (size_t column = area.firstColumn; column <= area.lastColumn; ++column)
+            sliceWeights[byColumns ? column - area.firstColumn : row - area.firstRow]
+                += cellWeights[row * columns + column];
+
+    double total = 0;
+    for (double weight : sliceWeights)
+        total += weight;
+
+    // Cut where the first side holds its share of the work, leaving at
+    // least a slice on each side
+    size_t firstParts = parts / 2;
+    double target = total * firstParts / parts;
+
+    size_t cut = 1;
+    double accumulated = sliceWeights[0];
+    while (cut < slices - 1 && accumulated + sliceWeights[cut] / 2 < target)
+        accumulated += sliceWeights[cut++];
+
+    Region first = area, second = area;
+    if (byColumns)
+    {
+        first.lastColumn = area.firstColumn + cut - 1;
+        second.firstColumn = area.firstColumn + cut;
+    }
+    else
+    {
+        first.lastRow = area.firstRow + cut - 1;
+        second.firstRow = area.firstRow + cut;
+    }
+
+    this->split(first, firstParts);
+    this->split(second, parts - firstParts);
+}
+
+// Getters
+
+const std::vector<SpatialDecomposition::Region>& SpatialDecomposition::getRegions() const
+{return regions;}
+
+size_t SpatialDecomposition::getRebalanceCount() const
+{return rebalanceCount;}
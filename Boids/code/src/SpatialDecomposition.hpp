@@ -0,0 +1,77 @@
+#ifndef SPATIAL_DECOMPOSITION_HPP
+#define SPATIAL_DECOMPOSITION_HPP
+
+// For per-region state
+#include <vector>
+
+// For the cells being split
+#include "UniformGrid.hpp"
+
+// Splits the grid's cells into one rectangular region per worker by
+// recursive bisection, cutting each rectangle along its longer side where
+// the estimated steering work on both sides matches their share of
+// workers. Work is estimated per cell as its boids times the boids in the
+// 3x3 cells around, which is what a neighbor scan visits. Regions are kept
+// across steps and only recut every so often, when the measured busy times
+// of workers drift too far apart
+class SpatialDecomposition
+{
+    public:
+        // Inclusive range of cells, empty when lastColumn < firstColumn
+        struct Region
+        {
+            size_t firstColumn;
+            size_t lastColumn;
+            size_t firstRow;
+            size_t lastRow;
+        };
+
+        // Whether steering is split by region rather than by index
+        bool enabled;
+
+        // Steps between imbalance checks
+        size_t rebalanceInterval;
+
+        // Ratio of the busiest worker's time to the average one above
+        // which regions are recut
+        double imbalanceThreshold;
+
+        // Default-construct disabled
+        SpatialDecomposition();
+
+        // Make sure there's one region per worker over the grid's current
+        // layout, recutting them if they're due and the latest step's
+        // imbalance between workers is above the threshold
+        void prepare(const UniformGrid& grid, size_t region_count, size_t step,
+            double imbalance);
+
+        // Get the regions, one per worker
+        const std::vector<Region>& getRegions() const;
+
+        // Get the amount of times regions were cut
+        size_t getRebalanceCount() const;
+
+    private:
+        std::vector<Region> regions;
+
+        // Grid layout the regions were cut for
+        size_t columns;
+        size_t rows;
+
+        size_t lastBalancedStep;
+        size_t rebalanceCount;
+
+        // Estimated steering work per cell, and per slice of the range
+        // being split. Both are kept across recuts, so that recutting
+        // doesn't allocate once they're as large as the grid needs
+        std::vector<double> cellWeights;
+        std::vector<double> sliceWeights;
+
+        // Cut regions over the grid anew
+        void bisect(const UniformGrid& grid, size_t region_count);
+
+        // Split a range of cells among the given amount of workers
+        void split(const Region& area, size_t parts);
+};
+
+#endif
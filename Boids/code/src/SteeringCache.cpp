@@ -0,0 +1,135 @@
+#include "SteeringCache.hpp"
+
+// For the grid and parameters
+#include "BoidWorld.hpp"
+
+// For headings
+#include "QuickMath.hpp"
+
+// For tolerances
+#include <cmath>
+
+// Constructor
+
+SteeringCache::SteeringCache() :
+positionTolerance(0.5f), headingTolerance(0.01f), hits(0), misses(0),
+separationC(0), allignmentC(0), cohesionC(0), senseRadius(0), 
+topologicalCount(0), sampleCount(0), neighborMode(NeighborMode::Metric)
+{}
+
+// Aggregation
+
+void SteeringCache::prepare(const BoidWorld& world)
+{
+    // Directions computed under other rules can't be reused
+    if (world.separationC != separationC || world.allignmentC != allignmentC
+        || world.cohesionC != cohesionC || world.senseRadius != senseRadius
+        || world.topologicalCount != topologicalCount 
+        || world.sampleCount != sampleCount
+        || world.neighborMode != neighborMode)
+    {
+        this->clear();
+
+        separationC = world.separationC;
+        allignmentC = world.allignmentC;
+        cohesionC = world.cohesionC;
+        senseRadius = world.senseRadius;
+        topologicalCount = world.topologicalCount;
+        sampleCount = world.sampleCount;
+        neighborMode = world.neighborMode;
+    }
+
+    if (entries.size() < world.boids.getIdCapacity())
+        entries.resize(world.boids.getIdCapacity(), Entry{{0, {}, {}}, 0, false, false});
+
+    // Sum every cell's run of the grid's sorted boids
+    const UniformGrid& grid = world.grid;
+    const std::vector<uint32_t>& indices = grid.getSortedIndices();
+    const std::vector<sf::Vector2f>& points = grid.getSortedPoints();
+
+    size_t cellCount = grid.getColumns() * grid.getRows();
+    cellCounts.assign(cellCount, 0);
+    cellPositions.assign(cellCount, sf::Vector2f(0, 0));
+    cellHeadings.assign(cellCount, sf::Vector2f(0, 0));
+
+    for (size_t cell = 0; cell < cellCount; ++cell)
+    {
+        cellCounts[cell] = grid.cellEnd(cell) - grid.cellBegin(cell);
+
+        for (size_t sorted = grid.cellBegin(cell); sorted < grid.cellEnd(cell); ++sorted)
+        {
+            float direction = QuickMath::degreesToRadians
+                (world.boids[indices[sorted]].getRotation());
+
+            cellPositions[cell] += points[sorted];
+            cellHeadings[cell] += sf::Vector2f(std::cos(direction), std::sin(direction));
+        }
+    }
+}
+
+SteeringCache::Signature SteeringCache::sign
+    (const BoidWorld& world, size_t boid_index) const
+{
+    // Same cells a metric grid lookup would scan
+    const UniformGrid& grid = world.grid;
+    const sf::Vector2f position = world.boids[boid_index].getPosition();
+    const float senseRadius = world.boids[boid_index].getSenseRadius(world);
+
+    const sf::Vector2f reach(senseRadius, senseRadius);
+
+    Signature signature = {0, sf::Vector2f(0, 0), sf::Vector2f(0, 0)};
+    grid.forEachRowRun(position - reach, position + reach, [&](size_t first, size_t last)
+    {
+        for (size_t cell = first; cell <= last; ++cell)
+        {
+            signature.count += cellCounts[cell];
+            signature.offset += cellPositions[cell];
+            signature.heading += cellHeadings[cell];
+        }
+    });
+
+    // The boid itself is always counted
+    signature.offset = signature.offset / static_cast<float>(signature.count) - position;
+    signature.heading /= static_cast<float>(signature.count);
+
+    return signature;
+}
+
+// Entries
+
+bool SteeringCache::lookup(BoidStorage::BoidId id, const Signature& signature,
+    float& desired_direction, bool& steers) const
+{
+    const Entry& entry = entries[id];
+    if (!entry.valid || entry.signature.count != signature.count)
+        return false;
+
+    sf::Vector2f offsetDrift = signature.offset - entry.signature.offset;
+    sf::Vector2f headingDrift = signature.heading - entry.signature.heading;
+
+    if (std::abs(offsetDrift.x) > positionTolerance 
+        || std::abs(offsetDrift.y) > positionTolerance
+        || std::abs(headingDrift.x) > headingTolerance 
+        || std::abs(headingDrift.y) > headingTolerance)
+        return false;
+
+    desired_direction = entry.desiredDirection;
+    steers = entry.steers;
+    return true;
+}
+
+void SteeringCache::store(BoidStorage::BoidId id, const Signature& signature,
+    float desired_direction, bool steers)
+{entries[id] = Entry{signature, desired_direction, steers, true};}
+
+void SteeringCache::invalidate(BoidStorage::BoidId id)
+{
+    if (id < entries.size())
+        entries[id].valid = false;
+}
+
+void SteeringCache::clear()
+{
+    for (Entry& entry : entries)
+        entry.valid = false;
+}
@@ -0,0 +1,103 @@
+#ifndef STEERING_CACHE_HPP
+#define STEERING_CACHE_HPP
+
+// For aggregate positions and headings
+#include <SFML/Graphics.hpp>
+
+// For per-cell and per-boid entries
+#include <vector>
+
+// For boid ids
+#include "BoidStorage.hpp"
+
+// For neighbor modes
+#include "SteeringPolicy.hpp"
+
+// Forward declaration, only handled through references
+class BoidWorld;
+
+// Memo of every boid's latest desired direction, reused for as long as the
+// grid cells around the boid look the same from where it stands. Cells are
+// aggregated once per step, so checking a boid costs a handful of cells
+// instead of a full neighbor scan. Boids drifting along inside a stable
+// flock keep hitting, while anything entering, leaving or turning nearby
+// forces a recomputation
+class SteeringCache
+{
+    public:
+        // Summary of the cells around a boid, relative to the boid
+        struct Signature
+        {
+            uint32_t count;
+
+            // Average position of the cells' boids, minus the boid's own
+            sf::Vector2f offset;
+
+            // Average heading of the cells' boids, as a vector
+            sf::Vector2f heading;
+        };
+
+        // Drift allowed in the average offset, in pixels, and in the
+        // average heading vector before recomputing
+        float positionTolerance;
+        float headingTolerance;
+
+        // Lookups that reused or recomputed a direction, during the latest
+        // step that used the cache
+        size_t hits;
+        size_t misses;
+
+        // Default-construct an empty cache
+        SteeringCache();
+
+        // Aggregate every cell of the world's freshly built grid, and make
+        // room for every boid id. Entries are dropped whenever the
+        // parameters steering depends on changed
+        void prepare(const BoidWorld& world);
+
+        // Get the signature of the cells around a boid
+        Signature sign(const BoidWorld& world, size_t boid_index) const;
+
+        // Get the cached direction of a boid, if its signature still matches.
+        // Steers is false for boids that had no neighbors to steer by
+        bool lookup(BoidStorage::BoidId id, const Signature& signature,
+            float& desired_direction, bool& steers) const;
+
+        // Remember the direction computed for a boid
+        void store(BoidStorage::BoidId id, const Signature& signature,
+            float desired_direction, bool steers);
+
+        // Drop a single boid's entry, as its id now names another boid
+        void invalidate(BoidStorage::BoidId id);
+
+        // Drop every entry
+        void clear();
+
+    private:
+        struct Entry
+        {
+            Signature signature;
+            float desiredDirection;
+            bool steers;
+            bool valid;
+        };
+
+        // Per-cell boid count, position sum and heading sum
+        std::vector<uint32_t> cellCounts;
+        std::vector<sf::Vector2f> cellPositions;
+        std::vector<sf::Vector2f> cellHeadings;
+
+        // Per-id entries
+        std::vector<Entry> entries;
+
+        // Parameters the entries were computed under
+        float separationC;
+        float allignmentC;
+        float cohesionC;
+        float senseRadius;
+        size_t topologicalCount;
+        size_t sampleCount;
+        NeighborMode neighborMode;
+};
+
+#endif
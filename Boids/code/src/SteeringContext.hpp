@@ -0,0 +1,52 @@
+#ifndef STEERING_CONTEXT_HPP
+#define STEERING_CONTEXT_HPP
+
+// For neighbor candidates
+#include <cstddef>
+#include <cstdint>
+#include <utility>
+#include <vector>
+
+// Forward declarations, only handled through pointers and references
+class ConcurrentUnionFind;
+class SteeringCache;
+class BoidWorld;
+struct SteeringContext;
+
+// Fills a context's ordered neighbors of a boid
+using NeighborGather = void (*)
+    (const BoidWorld& world, size_t boid_index, SteeringContext& context);
+
+// Mutable per-step state handed to the steering kernels, next to the
+// read-only world. There's one per worker thread
+struct SteeringContext
+{
+    // Sets of boids linked by neighborhood, only on analytics steps
+    ConcurrentUnionFind* flockUnion = nullptr;
+
+    // Max-heap of (squared distance, index) of the nearest boids found so
+    // far, for topological neighborhoods
+    std::vector<std::pair<float, uint32_t>> nearest;
+
+    // [begin, end) runs of sorted grid entries to sample neighbors from
+    std::vector<std::pair<uint32_t, uint32_t>> sampledRuns;
+
+    // Keys of the hashed cells already scanned for a boid
+    std::vector<uint32_t> cellKeys;
+
+    // (index, distance) of every neighbor, for visiting them in index
+    // order in deterministic mode, and what fills them in
+    std::vector<std::pair<uint32_t, double>> ordered;
+    NeighborGather gatherNeighbors = nullptr;
+
+    // Directions to reuse while surroundings don't change, only in lazy
+    // steering mode, and the lookups that did or didn't reuse one
+    SteeringCache* steeringCache = nullptr;
+    size_t cacheHits = 0;
+    size_t cacheMisses = 0;
+
+    // Boids steered this step, for what steering costs per boid
+    size_t steeredBoids = 0;
+};
+
+#endif
@@ -0,0 +1,55 @@
+#ifndef STEERING_POLICY_HPP
+#define STEERING_POLICY_HPP
+
+// How boids pick the neighbors they steer by
+enum class NeighborMode
+{
+    // Every boid within senseRadius
+    Metric,
+
+    // Only the topologicalCount nearest boids within senseRadius
+    Topological,
+
+    // At most sampleCount boids within senseRadius, drawn at random from
+    // the grid cells around
+    Sampled
+};
+
+// How metric neighborhoods are looked up
+enum class SpatialIndex
+{
+    // Check every other boid
+    BruteForce,
+
+    // Only check the cells overlapping senseRadius
+    Grid,
+
+    // Same, with cells found by hashed key over an unbounded plane
+    HashedGrid,
+
+    // Same, with cells of several power-of-two sizes, each boid scanning
+    // those matching its own sense radius
+    Hierarchical
+};
+
+// Compile-time selection of the steering rules and neighbor-pass features
+// in effect. Those switched off get compiled out of the neighbor loop
+// altogether
+template <bool Separation, bool Allignment, bool Cohesion, bool Analytics>
+struct SteeringPolicy
+{
+    static constexpr bool separation = Separation;
+    static constexpr bool allignment = Allignment;
+    static constexpr bool cohesion = Cohesion;
+
+    // Unite neighbors into flocks while visiting them
+    static constexpr bool analytics = Analytics;
+
+    // Whether there's anything to steer by
+    static constexpr bool steers = Separation || Allignment || Cohesion;
+
+    // Whether neighbors need visiting at all
+    static constexpr bool any = steers || Analytics;
+};
+
+#endif
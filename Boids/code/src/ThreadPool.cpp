@@ -0,0 +1,125 @@
+#include "ThreadPool.hpp"
+
+// For clamping the worker count
+#include <algorithm>
+
+// Constructor & Destructor
+
+ThreadPool::ThreadPool(size_t thread_count) :
+pendingTasks(0), rangeBody(nullptr), rangeTotal(0), rangeCount(0), nextRange(0),
+stopping(false)
+{
+    if (thread_count == 0)
+        thread_count = std::max(1u, std::thread::hardware_concurrency());
+
+    this->workers.reserve(thread_count);
+    for (size_t workerIter = 0; workerIter < thread_count; ++workerIter)
+        this->workers.emplace_back(&ThreadPool::work, this);
+}
+
+ThreadPool::~ThreadPool()
+{
+    {
+        std::lock_guard<std::mutex> lock(this->queueMutex);
+        this->stopping = true;
+    }
+
+    this->taskQueued.notify_all();
+    for (std::thread& worker : this->workers)
+        worker.join();
+}
+
+// Getters
+
+size_t ThreadPool::getThreadCount() const
+{return this->workers.size();}
+
+// Scheduling
+
+void ThreadPool::submit(std::function<void()> task)
+{
+    {
+        std::lock_guard<std::mutex> lock(this->queueMutex);
+        this->tasks.push(std::move(task));
+        ++this->pendingTasks;
+    }
+
+    this->taskQueued.notify_one();
+}
+
+void ThreadPool::wait()
+{
+    std::unique_lock<std::mutex> lock(this->queueMutex);
+    this->tasksFinished.wait(lock, [this] {return this->pendingTasks == 0;});
+}
+
+void ThreadPool::parallelFor(size_t count, RangeFunction body)
+{
+    size_t ranges = std::min(count, this->workers.size());
+    if (ranges == 0)
+        return;
+
+    {
+        std::lock_guard<std::mutex> lock(this->queueMutex);
+        this->rangeBody = &body;
+        this->rangeTotal = count;
+        this->rangeCount = ranges;
+        this->nextRange = 0;
+        this->pendingTasks += ranges;
+    }
+
+    this->taskQueued.notify_all();
+    this->wait();
+
+    std::lock_guard<std::mutex> lock(this->queueMutex);
+    this->rangeBody = nullptr;
+    this->rangeCount = 0;
+    this->nextRange = 0;
+}
+
+void ThreadPool::work()
+{
+    while (true)
+    {
+        std::function<void()> task;
+        const RangeFunction* body = nullptr;
+        size_t range = 0, ranges = 0, total = 0;
+
+        // Sleep until there's either work or a request to stop. Ranges come
+        // before queued tasks, and queued work is always drained before
+        // stopping
+        {
+            std::unique_lock<std::mutex> lock(this->queueMutex);
+            this->taskQueued.wait(lock, [this]
+                {return this->stopping || !this->tasks.empty() 
+                    || this->nextRange < this->rangeCount;});
+
+            if (this->nextRange < this->rangeCount)
+            {
+                body = this->rangeBody;
+                range = this->nextRange++;
+                ranges = this->rangeCount;
+                total = this->rangeTotal;
+            }
+
+            else if (this->tasks.empty())
+                return;
+
+            else
+            {
+                task = std::move(this->tasks.front());
+                this->tasks.pop();
+            }
+        }
+
+        if (body)
+            (*body)(total * range / ranges, total * (range + 1) / ranges, range);
+        else
+            task();
+
+        // Wake up anyone waiting on the last task
+        std::lock_guard<std::mutex> lock(this->queueMutex);
+        if (--this->pendingTasks == 0)
+            this->tasksFinished.notify_all();
+    }
+}
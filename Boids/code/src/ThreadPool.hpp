@@ -0,0 +1,92 @@
+#ifndef THREAD_POOL_HPP
+#define THREAD_POOL_HPP
+
+// For workers and their synchronization
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+
+// For the task queue
+#include <functional>
+#include <queue>
+#include <vector>
+
+// For telling range bodies apart from references to them
+#include <type_traits>
+
+// Fixed set of worker threads draining a shared task queue
+class ThreadPool
+{
+    public:
+        // Non-owning reference to a callable taking (begin, end, worker).
+        // Unlike std::function it never allocates, so the callable must
+        // outlive it
+        class RangeFunction
+        {
+            public:
+                template <typename Body, typename = std::enable_if_t
+                    <!std::is_same_v<std::decay_t<Body>, RangeFunction>>>
+                RangeFunction(Body&& body) :
+                object(const_cast<void*>(static_cast<const void*>(&body))),
+                call([](void* object, size_t begin, size_t end, size_t worker)
+                    {(*static_cast<std::remove_reference_t<Body>*>(object))(begin, end, worker);})
+                {}
+
+                void operator()(size_t begin, size_t end, size_t worker) const
+                {this->call(this->object, begin, end, worker);}
+
+            private:
+                void* object;
+                void (*call)(void*, size_t, size_t, size_t);
+        };
+
+        // Spawn the given amount of workers. Zero means one per hardware
+        // thread
+        explicit ThreadPool(size_t thread_count = 0);
+
+        // Forbid any copy-construction or copy-assignment
+        ThreadPool(ThreadPool const&) = delete;
+        ThreadPool& operator=(ThreadPool const&) = delete;
+
+        // Finish every queued task, then join the workers
+        ~ThreadPool();
+
+        // Get the amount of workers
+        size_t getThreadCount() const;
+
+        // Queue a task for the next idle worker
+        void submit(std::function<void()> task);
+
+        // Block until every queued task has finished
+        void wait();
+
+        // Split [0, count) into one contiguous range per worker and run the
+        // body over each as (begin, end, worker), blocking until all are
+        // done. Worker indices are below getThreadCount(). Ranges are handed
+        // out without queueing tasks, so nothing is allocated, but only one
+        // thread may run a parallelFor at a time
+        void parallelFor(size_t count, RangeFunction body);
+
+    private:
+        std::vector<std::thread> workers;
+        std::queue<std::function<void()>> tasks;
+
+        // Tasks either queued or running, ranges included
+        size_t pendingTasks;
+
+        // Ranges of the running parallelFor, and the next one to hand out
+        const RangeFunction* rangeBody;
+        size_t rangeTotal;
+        size_t rangeCount;
+        size_t nextRange;
+        bool stopping;
+
+        std::mutex queueMutex;
+        std::condition_variable taskQueued;
+        std::condition_variable tasksFinished;
+
+        // Worker loop
+        void work();
+};
+
+#endif
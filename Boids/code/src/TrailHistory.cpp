@@ -0,0 +1,70 @@
+#include "TrailHistory.hpp"
+
+// For filling trails
+#include <algorithm>
+
+// Constructor
+
+TrailHistory::TrailHistory() :
+length(0), head(0)
+{}
+
+// Setup
+
+void TrailHistory::setLength(size_t trail_length, size_t id_capacity)
+{
+    this->length = trail_length;
+    this->head = 0;
+
+    this->positions.clear();
+    this->positions.shrink_to_fit();
+    this->reserveIds(id_capacity);
+}
+
+size_t TrailHistory::getLength() const
+{return this->length;}
+
+void TrailHistory::reserveIds(size_t id_capacity)
+{
+    // Trails are laid out id after id, so growing only appends
+    if (id_capacity * this->length > this->positions.size())
+        this->positions.resize(id_capacity * this->length);
+}
+
+void TrailHistory::resetTrail(BoidStorage::BoidId id, const sf::Vector2f& position)
+{
+    auto trail = this->positions.begin() + id * this->length;
+    std::fill(trail, trail + this->length, position);
+}
+
+// Recording
+
+void TrailHistory::record(BoidStorage::BoidId id, const sf::Vector2f& position)
+{this->positions[id * this->length + this->head] = position;}
+
+void TrailHistory::advance()
+{
+    if (this->length != 0)
+        this->head = (this->head + 1) % this->length;
+}
+
+void TrailHistory::copyOrdered(const BoidStorage& boids, std::vector<sf::Vector2f>& trails) const
+{
+    trails.resize(boids.size() * this->length);
+    if (this->length == 0)
+        return;
+
+    // Starting at the head, which holds the oldest position after advancing,
+    // copy the ring in two contiguous runs
+    for (size_t boidIter = 0; boidIter < boids.size(); ++boidIter)
+    {
+        auto trail = this->positions.begin() + boids.getId(boidIter) * this->length;
+        auto copied = trails.begin() + boidIter * this->length;
+
+        copied = std::copy(trail + this->head, trail + this->length, copied);
+        std::copy(trail, trail + this->head, copied);
+    }
+}
+
+size_t TrailHistory::getMemoryBytes() const
+{return this->positions.capacity() * sizeof(sf::Vector2f);}
@@ -0,0 +1,58 @@
+#ifndef TRAIL_HISTORY_HPP
+#define TRAIL_HISTORY_HPP
+
+// For positions
+#include <SFML/Graphics.hpp>
+
+// For the ring buffer
+#include <vector>
+
+// For boid ids
+#include "BoidStorage.hpp"
+
+// Fixed-length position history of every boid, kept in one contiguous ring
+// buffer indexed by (boid id, slot). All boids share the same write slot,
+// which advances once per step
+class TrailHistory
+{
+    public:
+        // Default-construct with trails disabled
+        TrailHistory();
+
+        // Set the amount of positions kept per boid, for ids below the given
+        // capacity. Zero disables trails. Drops every recorded position
+        void setLength(size_t trail_length, size_t id_capacity);
+
+        // Get the amount of positions kept per boid
+        size_t getLength() const;
+
+        // Make room for ids below the given capacity
+        void reserveIds(size_t id_capacity);
+
+        // Fill a boid's whole trail with a single position, for new boids
+        void resetTrail(BoidStorage::BoidId id, const sf::Vector2f& position);
+
+        // Write a boid's position into the current slot. Boids may be
+        // recorded concurrently
+        void record(BoidStorage::BoidId id, const sf::Vector2f& position);
+
+        // Move on to the next slot, once every boid was recorded
+        void advance();
+
+        // Copy the trails of every live boid in dense order, oldest
+        // position first
+        void copyOrdered(const BoidStorage& boids, std::vector<sf::Vector2f>& trails) const;
+
+        // Get the memory held by the history
+        size_t getMemoryBytes() const;
+
+    private:
+        size_t length;
+
+        // Slot written this step, and oldest slot after advancing
+        size_t head;
+
+        std::vector<sf::Vector2f> positions;
+};
+
+#endif
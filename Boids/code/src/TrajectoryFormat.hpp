@@ -0,0 +1,133 @@
+#ifndef TRAJECTORY_FORMAT_HPP
+#define TRAJECTORY_FORMAT_HPP
+
+// For fixed-width integers
+#include <cstdint>
+
+// For reinterpreting floats
+#include <cstring>
+
+// For encoded bytes
+#include <vector>
+
+// Layout of trajectory files, and the integer codings they use. Everything
+// is little-endian.
+//
+// A file starts with the magic, a version and the position quantum, then
+// holds chunks. A chunk covers consecutive steps of a fixed set of boids
+// and starts with its first step, step count, boid count and payload size,
+// followed by the id of every boid and the end offset of its stream within
+// the payload. Each boid's stream holds its position at every step of the
+// chunk, in quanta, each as the zigzag varint change since the step before
+// (since zero for the first), x then y. Readers can skip chunks by their
+// header alone, and boids by their offsets alone
+namespace TrajectoryFormat
+{
+    constexpr char magic[8] = {'B', 'O', 'I', 'D', 'T', 'R', 'J', 'C'};
+    constexpr uint32_t version = 1;
+
+    // Magic, version and quantum
+    constexpr size_t fileHeaderBytes = 16;
+
+    // First step, step count, boid count and payload size
+    constexpr size_t chunkHeaderBytes = 24;
+
+    // Id and stream end offset
+    constexpr size_t boidEntryBytes = 8;
+
+    // Longest varint of a 64-bit value
+    constexpr size_t maxVarintBytes = 10;
+
+    // Append fixed-width values
+    inline void putU32(std::vector<uint8_t>& bytes, uint32_t value)
+    {
+        for (int shift = 0; shift < 32; shift += 8)
+            bytes.push_back(static_cast<uint8_t>(value >> shift));
+    }
+
+    inline void putU64(std::vector<uint8_t>& bytes, uint64_t value)
+    {
+        for (int shift = 0; shift < 64; shift += 8)
+            bytes.push_back(static_cast<uint8_t>(value >> shift));
+    }
+
+    inline void putFloat(std::vector<uint8_t>& bytes, float value)
+    {
+        uint32_t bits;
+        std::memcpy(&bits, &value, sizeof(bits));
+        putU32(bytes, bits);
+    }
+
+    // Overwrite fixed-width values, for sizes known after the fact
+    inline void setU32(uint8_t* bytes, uint32_t value)
+    {
+        for (int byte = 0; byte < 4; ++byte)
+            bytes[byte] = static_cast<uint8_t>(value >> (byte * 8));
+    }
+
+    inline void setU64(uint8_t* bytes, uint64_t value)
+    {
+        setU32(bytes, static_cast<uint32_t>(value));
+        setU32(bytes + 4, static_cast<uint32_t>(value >> 32));
+    }
+
+    // Read fixed-width values
+    inline uint32_t getU32(const uint8_t* bytes)
+    {
+        uint32_t value = 0;
+        for (int byte = 3; byte >= 0; --byte)
+            value = value << 8 | bytes[byte];
+
+        return value;
+    }
+
+    inline uint64_t getU64(const uint8_t* bytes)
+    {return static_cast<uint64_t>(getU32(bytes + 4)) << 32 | getU32(bytes);}
+
+    inline float getFloat(const uint8_t* bytes)
+    {
+        uint32_t bits = getU32(bytes);
+        float value;
+        std::memcpy(&value, &bits, sizeof(value));
+        return value;
+    }
+
+    // Map signed values to unsigned ones, small magnitudes to small values
+    inline uint64_t zigzag(int64_t value)
+    {return (static_cast<uint64_t>(value) << 1) ^ static_cast<uint64_t>(value >> 63);}
+
+    inline int64_t unzigzag(uint64_t value)
+    {return static_cast<int64_t>(value >> 1) ^ -static_cast<int64_t>(value & 1);}
+
+    // Append a value seven bits at a time, the high bit of each byte
+    // flagging that more follow
+    inline void putVarint(std::vector<uint8_t>& bytes, uint64_t value)
+    {
+        while (value >= 0x80)
+        {
+            bytes.push_back(static_cast<uint8_t>(value) | 0x80);
+            value >>= 7;
+        }
+
+        bytes.push_back(static_cast<uint8_t>(value));
+    }
+
+    // Read a varint, moving the cursor past it. False if it runs past the
+    // end or is too long
+    inline bool getVarint(const uint8_t*& cursor, const uint8_t* end, uint64_t& value)
+    {
+        value = 0;
+        for (int shift = 0; shift < 64 && cursor != end; shift += 7)
+        {
+            uint8_t byte = *cursor++;
+            value |= static_cast<uint64_t>(byte & 0x7F) << shift;
+
+            if (!(byte & 0x80))
+                return true;
+        }
+
+        return false;
+    }
+}
+
+#endif
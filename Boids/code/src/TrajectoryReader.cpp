@@ -0,0 +1,151 @@
+#include "TrajectoryReader.hpp"
+
+// For the layout and codings
+#include "TrajectoryFormat.hpp"
+
+// For looking requested boids up
+#include <algorithm>
+
+// Constructor
+
+TrajectoryReader::TrajectoryReader() :
+quantum(1)
+{}
+
+// File control
+
+bool TrajectoryReader::open(const std::string& path)
+{
+    this->file.close();
+    this->file.clear();
+    this->file.open(path, std::ios::binary);
+
+    uint8_t header[TrajectoryFormat::fileHeaderBytes];
+    if (!this->file.read(reinterpret_cast<char*>(header), sizeof(header)))
+        return false;
+
+    if (!std::equal(TrajectoryFormat::magic,
+            TrajectoryFormat::magic + sizeof(TrajectoryFormat::magic), header)
+        || TrajectoryFormat::getU32(header + 8) != TrajectoryFormat::version)
+        return false;
+
+    this->quantum = TrajectoryFormat::getFloat(header + 12);
+    return true;
+}
+
+float TrajectoryReader::getQuantum() const
+{return this->quantum;}
+
+// Reading
+
+bool TrajectoryReader::read(size_t first_step, size_t last_step,
+    const std::vector<BoidStorage::BoidId>& boid_ids, const TrackVisitor& visit)
+{
+    std::vector<BoidStorage::BoidId> wanted = boid_ids;
+    std::sort(wanted.begin(), wanted.end());
+    bool everyBoid = wanted.empty();
+
+    this->file.clear();
+    this->file.seekg(TrajectoryFormat::fileHeaderBytes);
+
+    // Steps restart whenever the world does, so every chunk header is
+    // looked at, but nothing else of chunks outside the range
+    while (true)
+    {
+        std::streamoff chunkStart = this->file.tellg();
+
+        uint8_t header[TrajectoryFormat::chunkHeaderBytes];
+        if (!this->file.read(reinterpret_cast<char*>(header), sizeof(header)))
+            return true;
+
+        size_t chunkStep = TrajectoryFormat::getU64(header);
+        size_t stepCount = TrajectoryFormat::getU32(header + 8);
+        size_t boidCount = TrajectoryFormat::getU32(header + 12);
+        size_t payloadBytes = TrajectoryFormat::getU64(header + 16);
+        if (stepCount == 0)
+            return false;
+
+        std::streamoff payloadStart = chunkStart + sizeof(header)
+            + boidCount * TrajectoryFormat::boidEntryBytes;
+        std::streamoff nextChunk = payloadStart + payloadBytes;
+
+        if (chunkStep > last_step || chunkStep + stepCount <= first_step)
+        {
+            this->file.seekg(nextChunk);
+            continue;
+        }
+
+        this->table.resize(boidCount * TrajectoryFormat::boidEntryBytes);
+        if (!this->file.read(reinterpret_cast<char*>(this->table.data()), this->table.size()))
+            return true;
+
+        // Every stream is needed, so read them all at once
+        if (everyBoid)
+        {
+            this->stream.resize(payloadBytes);
+            if (!this->file.read(reinterpret_cast<char*>(this->stream.data()), payloadBytes))
+                return true;
+        }
+
+        size_t streamBegin = 0;
+        for (size_t boidIter = 0; boidIter < boidCount; ++boidIter)
+        {
+            const uint8_t* entry = &this->table[boidIter * TrajectoryFormat::boidEntryBytes];
+            BoidStorage::BoidId id = TrajectoryFormat::getU32(entry);
+            size_t streamEnd = TrajectoryFormat::getU32(entry + 4);
+            if (streamEnd < streamBegin || streamEnd > payloadBytes)
+                return false;
+
+            size_t begin = streamBegin;
+            streamBegin = streamEnd;
+
+            const uint8_t* bytes = this->stream.data() + begin;
+            if (!everyBoid)
+            {
+                if (!std::binary_search(wanted.begin(), wanted.end(), id))
+                    continue;
+
+                this->stream.resize(streamEnd - begin);
+                this->file.seekg(payloadStart + begin);
+                if (!this->file.read(reinterpret_cast<char*>(this->stream.data()), this->stream.size()))
+                    return true;
+
+                bytes = this->stream.data();
+            }
+
+            if (!this->decodeTrack(id, bytes, bytes + (streamEnd - begin),
+                    chunkStep, stepCount, first_step, last_step, visit))
+                return false;
+        }
+
+        this->file.seekg(nextChunk);
+    }
+}
+
+bool TrajectoryReader::decodeTrack(BoidStorage::BoidId id, const uint8_t* begin, const uint8_t* end,
+    size_t chunk_step, size_t step_count, size_t first_step, size_t last_step,
+    const TrackVisitor& visit)
+{
+    // Changes build on each other, so decoding starts at the chunk's start
+    // but stops after the range
+    size_t decoded = std::min(step_count, last_step - chunk_step + 1);
+
+    this->track.clear();
+    int64_t x = 0, y = 0;
+    for (size_t stepIter = 0; stepIter < decoded; ++stepIter)
+    {
+        uint64_t changeX, changeY;
+        if (!TrajectoryFormat::getVarint(begin, end, changeX)
+            || !TrajectoryFormat::getVarint(begin, end, changeY))
+            return false;
+
+        x += TrajectoryFormat::unzigzag(changeX);
+        y += TrajectoryFormat::unzigzag(changeY);
+
+        if (chunk_step + stepIter >= first_step)
+            this->track.emplace_back(x * this->quantum, y * this->quantum);
+    }
+
+    visit(id, std::max(chunk_step, first_step), this->track);
+    return true;
+}
@@ -0,0 +1,63 @@
+#ifndef TRAJECTORY_READER_HPP
+#define TRAJECTORY_READER_HPP
+
+// For positions
+#include <SFML/Graphics.hpp>
+
+// For the input file
+#include <fstream>
+#include <string>
+
+// For handing tracks over
+#include <functional>
+
+// For decoded tracks
+#include <vector>
+
+// For boid ids
+#include "BoidStorage.hpp"
+
+// Streams positions back out of a trajectory file, laid out as described in
+// TrajectoryFormat. Only the headers of chunks outside the requested steps
+// are read, and only the streams of the requested boids within them
+class TrajectoryReader
+{
+    public:
+        // Handles consecutive positions of one boid, starting at the given
+        // step
+        using TrackVisitor = std::function<void(BoidStorage::BoidId id,
+            size_t first_step, const std::vector<sf::Vector2f>& positions)>;
+
+        // Default-construct closed
+        TrajectoryReader();
+
+        // Open a trajectory file. False if it can't be read or isn't one
+        bool open(const std::string& path);
+
+        // Get the position resolution the file was written with
+        float getQuantum() const;
+
+        // Decode the positions of the given boids, or of every boid if none
+        // are given, over steps [first_step, last_step]. Every chunk hands
+        // each of its requested boids over as one track. False if the file
+        // turns out malformed, though a chunk cut short at the end of the
+        // file, as left by a writer that never closed, just ends reading
+        bool read(size_t first_step, size_t last_step,
+            const std::vector<BoidStorage::BoidId>& boid_ids, const TrackVisitor& visit);
+
+    private:
+        std::ifstream file;
+        float quantum;
+
+        // Per-chunk buffers
+        std::vector<uint8_t> table;
+        std::vector<uint8_t> stream;
+        std::vector<sf::Vector2f> track;
+
+        // Decode a boid's stream, handing over the steps within the range
+        bool decodeTrack(BoidStorage::BoidId id, const uint8_t* begin, const uint8_t* end,
+            size_t chunk_step, size_t step_count, size_t first_step, size_t last_step,
+            const TrackVisitor& visit);
+};
+
+#endif
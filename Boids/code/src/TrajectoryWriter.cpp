@@ -0,0 +1,195 @@
+#include "TrajectoryWriter.hpp"
+
+// For the layout and codings
+#include "TrajectoryFormat.hpp"
+
+// For quantizing positions
+#include <cmath>
+
+// Constructor & Destructor
+
+TrajectoryWriter::TrajectoryWriter() :
+quantum(1.f / 256), chunkSteps(64), maxQueuedChunks(4),
+opened(false), fileQuantum(1), closing(false), writtenBytes(0), failed(false)
+{}
+
+TrajectoryWriter::~TrajectoryWriter()
+{this->close();}
+
+// File control
+
+bool TrajectoryWriter::open(const std::string& path)
+{
+    this->close();
+
+    this->file.open(path, std::ios::binary | std::ios::trunc);
+    if (!this->file)
+        return false;
+
+    std::vector<uint8_t> header(TrajectoryFormat::magic,
+        TrajectoryFormat::magic + sizeof(TrajectoryFormat::magic));
+    TrajectoryFormat::putU32(header, TrajectoryFormat::version);
+    TrajectoryFormat::putFloat(header, this->quantum);
+    this->file.write(reinterpret_cast<const char*>(header.data()), header.size());
+
+    this->fileQuantum = this->quantum;
+    this->current = Chunk();
+    this->closing = false;
+    this->writtenBytes = header.size();
+    this->failed = !this->file;
+    this->opened = true;
+
+    this->writerThread = std::thread(&TrajectoryWriter::writeChunks, this);
+    return true;
+}
+
+bool TrajectoryWriter::isOpen() const
+{return this->opened;}
+
+bool TrajectoryWriter::close()
+{
+    if (!this->opened)
+        return true;
+
+    if (this->current.stepCount != 0)
+        this->submit();
+
+    {
+        std::lock_guard<std::mutex> lock(this->queueMutex);
+        this->closing = true;
+    }
+    this->chunkQueued.notify_one();
+    this->writerThread.join();
+
+    this->file.close();
+    this->opened = false;
+
+    return !this->failed && !this->file.fail();
+}
+
+size_t TrajectoryWriter::getWrittenBytes() const
+{return this->writtenBytes;}
+
+// Recording
+
+void TrajectoryWriter::record(size_t step, const BoidStorage& boids)
+{
+    if (!this->opened)
+        return;
+
+    Chunk& chunk = this->current;
+    size_t boidCount = boids.size();
+
+    // Chunks hold consecutive steps of the same boids in the same order,
+    // and stay small enough for 32-bit stream offsets
+    if (chunk.stepCount != 0)
+    {
+        bool continues = step == chunk.firstStep + chunk.stepCount
+            && boidCount == chunk.ids.size();
+        for (size_t boidIter = 0; continues && boidIter < boidCount; ++boidIter)
+            continues = boids.getId(boidIter) == chunk.ids[boidIter];
+
+        bool full = chunk.stepCount >= this->chunkSteps || (chunk.stepCount + 1)
+            * boidCount * 2 * TrajectoryFormat::maxVarintBytes > UINT32_MAX;
+
+        if (!continues || full)
+            this->submit();
+    }
+
+    if (chunk.stepCount == 0)
+    {
+        chunk.firstStep = step;
+        chunk.ids.resize(boidCount);
+        for (size_t boidIter = 0; boidIter < boidCount; ++boidIter)
+            chunk.ids[boidIter] = boids.getId(boidIter);
+    }
+
+    for (size_t boidIter = 0; boidIter < boidCount; ++boidIter)
+    {
+        sf::Vector2f position = boids[boidIter].getPosition();
+        chunk.samples.push_back(std::llround(position.x / this->fileQuantum));
+        chunk.samples.push_back(std::llround(position.y / this->fileQuantum));
+    }
+
+    ++chunk.stepCount;
+}
+
+void TrajectoryWriter::submit()
+{
+    {
+        std::unique_lock<std::mutex> lock(this->queueMutex);
+        this->chunkTaken.wait(lock, [this]
+            {return this->queue.size() < std::max<size_t>(this->maxQueuedChunks, 1);});
+
+        this->queue.push_back(std::move(this->current));
+    }
+
+    this->chunkQueued.notify_one();
+    this->current = Chunk();
+}
+
+// Writing
+
+void TrajectoryWriter::writeChunks()
+{
+    std::vector<uint8_t> bytes;
+    while (true)
+    {
+        Chunk chunk;
+        {
+            std::unique_lock<std::mutex> lock(this->queueMutex);
+            this->chunkQueued.wait(lock, [this]
+                {return !this->queue.empty() || this->closing;});
+
+            if (this->queue.empty())
+                return;
+
+            chunk = std::move(this->queue.front());
+            this->queue.pop_front();
+        }
+        this->chunkTaken.notify_one();
+
+        bytes.clear();
+        encode(chunk, bytes);
+
+        if (!this->file.write(reinterpret_cast<const char*>(bytes.data()), bytes.size()))
+            this->failed = true;
+
+        this->writtenBytes += bytes.size();
+    }
+}
+
+void TrajectoryWriter::encode(const Chunk& chunk, std::vector<uint8_t>& bytes)
+{
+    size_t boidCount = chunk.ids.size();
+
+    // Header and table, with sizes and offsets filled in as streams are
+    TrajectoryFormat::putU64(bytes, chunk.firstStep);
+    TrajectoryFormat::putU32(bytes, chunk.stepCount);
+    TrajectoryFormat::putU32(bytes, boidCount);
+    TrajectoryFormat::putU64(bytes, 0);
+
+    size_t table = bytes.size();
+    bytes.resize(table + boidCount * TrajectoryFormat::boidEntryBytes);
+
+    size_t payload = bytes.size();
+    for (size_t boidIter = 0; boidIter < boidCount; ++boidIter)
+    {
+        int64_t lastX = 0, lastY = 0;
+        for (size_t stepIter = 0; stepIter < chunk.stepCount; ++stepIter)
+        {
+            const int64_t* sample = &chunk.samples[(stepIter * boidCount + boidIter) * 2];
+            TrajectoryFormat::putVarint(bytes, TrajectoryFormat::zigzag(sample[0] - lastX));
+            TrajectoryFormat::putVarint(bytes, TrajectoryFormat::zigzag(sample[1] - lastY));
+
+            lastX = sample[0];
+            lastY = sample[1];
+        }
+
+        uint8_t* entry = &bytes[table + boidIter * TrajectoryFormat::boidEntryBytes];
+        TrajectoryFormat::setU32(entry, chunk.ids[boidIter]);
+        TrajectoryFormat::setU32(entry + 4, bytes.size() - payload);
+    }
+
+    TrajectoryFormat::setU64(&bytes[table - 8], bytes.size() - payload);
+}
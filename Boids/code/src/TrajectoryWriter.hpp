@@ -0,0 +1,107 @@
+#ifndef TRAJECTORY_WRITER_HPP
+#define TRAJECTORY_WRITER_HPP
+
+// For the output file
+#include <fstream>
+#include <string>
+
+// For the writing thread and its queue
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <mutex>
+#include <thread>
+
+// For buffered samples
+#include <vector>
+
+// For boids and their ids
+#include "BoidStorage.hpp"
+
+// Records every boid's position each step into a trajectory file, laid out
+// as described in TrajectoryFormat. Recording only quantizes positions into
+// the current chunk. Full chunks are encoded and written by a background
+// thread, a whole chunk per write, so stepping never waits on the disk
+// unless maxQueuedChunks chunks are already waiting
+class TrajectoryWriter
+{
+    public:
+        // Position resolution, in world units. Applies to files opened
+        // afterwards
+        float quantum;
+
+        // Steps per chunk. Chunks also end early whenever boids are spawned,
+        // despawned or moved around, or steps are skipped
+        size_t chunkSteps;
+
+        // Full chunks that may wait for the writing thread before recording
+        // blocks
+        size_t maxQueuedChunks;
+
+        // Default-construct closed
+        TrajectoryWriter();
+
+        // Forbid any copy-construction or copy-assignment
+        TrajectoryWriter(TrajectoryWriter const&) = delete;
+        TrajectoryWriter& operator=(TrajectoryWriter const&) = delete;
+
+        // Finish writing, if open
+        ~TrajectoryWriter();
+
+        // Start a new file, closing any previous one. False if it can't be
+        // created
+        bool open(const std::string& path);
+
+        // Check whether a file is being written
+        bool isOpen() const;
+
+        // Record the position of every boid after the given step
+        void record(size_t step, const BoidStorage& boids);
+
+        // Write whatever was recorded and close the file. False if any write
+        // failed
+        bool close();
+
+        // Get the bytes written to the file so far
+        size_t getWrittenBytes() const;
+
+    private:
+        // Positions of a fixed set of boids over consecutive steps, in
+        // quanta, step after step
+        struct Chunk
+        {
+            size_t firstStep = 0;
+            size_t stepCount = 0;
+            std::vector<BoidStorage::BoidId> ids;
+            std::vector<int64_t> samples;
+        };
+
+        std::ofstream file;
+        bool opened;
+        float fileQuantum;
+
+        Chunk current;
+
+        // Chunks waiting for the writing thread, and whether it should
+        // finish once they're written
+        std::deque<Chunk> queue;
+        bool closing;
+        std::mutex queueMutex;
+        std::condition_variable chunkQueued;
+        std::condition_variable chunkTaken;
+
+        std::thread writerThread;
+        std::atomic<size_t> writtenBytes;
+        std::atomic<bool> failed;
+
+        // Hand the current chunk over to the writing thread
+        void submit();
+
+        // Writing thread loop
+        void writeChunks();
+
+        // Append a chunk's header, table and streams
+        static void encode(const Chunk& chunk, std::vector<uint8_t>& bytes);
+};
+
+#endif
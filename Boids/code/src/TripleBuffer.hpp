@@ -0,0 +1,68 @@
+#ifndef TRIPLE_BUFFER_HPP
+#define TRIPLE_BUFFER_HPP
+
+// For the lock-free hand-off
+#include <atomic>
+#include <cstdint>
+
+// Lock-free hand-off of the latest value from a single producer thread to
+// a single consumer thread. The producer fills its back buffer and publishes
+// it, the consumer fetches whatever was published last, and neither ever
+// waits on the other
+template <typename T>
+class TripleBuffer
+{
+    public:
+        // Default-construct with nothing published yet
+        TripleBuffer() :
+        middle(1), backIndex(0), frontIndex(2)
+        {}
+
+        // Forbid any copy-construction or copy-assignment
+        TripleBuffer(TripleBuffer const&) = delete;
+        TripleBuffer& operator=(TripleBuffer const&) = delete;
+
+        // Get the buffer the producer writes to
+        T& back()
+        {return this->buffers[this->backIndex];}
+
+        // Hand the back buffer over, taking the idle one in its place
+        void publish()
+        {
+            uint8_t previous = this->middle.exchange
+                (this->backIndex | freshFlag, std::memory_order_acq_rel);
+            this->backIndex = previous & indexMask;
+        }
+
+        // Take over the latest published buffer, if any was published since
+        // the last fetch. True if the front buffer changed
+        bool fetch()
+        {
+            if (!(this->middle.load(std::memory_order_relaxed) & freshFlag))
+                return false;
+
+            uint8_t previous = this->middle.exchange
+                (this->frontIndex, std::memory_order_acq_rel);
+            this->frontIndex = previous & indexMask;
+            return true;
+        }
+
+        // Get the buffer the consumer reads from
+        const T& front() const
+        {return this->buffers[this->frontIndex];}
+
+    private:
+        static constexpr uint8_t indexMask = 0x3;
+        static constexpr uint8_t freshFlag = 0x4;
+
+        T buffers[3];
+
+        // Index of the idle buffer, flagged when it holds unread data
+        std::atomic<uint8_t> middle;
+
+        // Owned by the producer and the consumer respectively
+        uint8_t backIndex;
+        uint8_t frontIndex;
+};
+
+#endif
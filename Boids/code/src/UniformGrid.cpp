@@ -0,0 +1,89 @@
+#include "UniformGrid.hpp"
+
+// For clamping cells
+#include <algorithm>
+#include <cmath>
+
+// Constructor
+
+UniformGrid::UniformGrid() :
+cellSize(1), columns(0), rows(0)
+{}
+
+// Building
+
+void UniformGrid::build(std::span<const sf::Vector2f> points, 
+    const sf::FloatRect& grid_area, float cell_size)
+{
+    this->area = grid_area;
+    this->cellSize = cell_size;
+    this->columns = std::max(1.f, std::ceil(grid_area.width / cell_size));
+    this->rows = std::max(1.f, std::ceil(grid_area.height / cell_size));
+
+    size_t pointCount = points.size();
+    this->pointCells.resize(pointCount);
+    this->sortedIndices.resize(pointCount);
+    this->sortedPoints.resize(pointCount);
+    this->cellStarts.assign(this->columns * this->rows + 1, 0);
+
+    // Counting sort: count, prefix-sum, then scatter
+    for (size_t pointIter = 0; pointIter < pointCount; ++pointIter)
+    {
+        uint32_t cell = this->rowOf(points[pointIter].y) * this->columns 
+            + this->columnOf(points[pointIter].x);
+
+        this->pointCells[pointIter] = cell;
+        ++this->cellStarts[cell];
+    }
+
+    for (size_t cellIter = 1; cellIter < this->cellStarts.size(); ++cellIter)
+        this->cellStarts[cellIter] += this->cellStarts[cellIter - 1];
+
+    // Each entry now holds its cell's end. Scatter backwards using it as
+    // the fill cursor, which leaves it at the cell's start once done, and
+    // keeps points in index order within each cell
+    for (size_t pointIter = pointCount; pointIter-- > 0;)
+    {
+        uint32_t sorted = --this->cellStarts[this->pointCells[pointIter]];
+        this->sortedIndices[sorted] = pointIter;
+        this->sortedPoints[sorted] = points[pointIter];
+    }
+}
+
+// Getters
+
+float UniformGrid::getCellSize() const
+{return this->cellSize;}
+
+size_t UniformGrid::getColumns() const
+{return this->columns;}
+
+size_t UniformGrid::getRows() const
+{return this->rows;}
+
+const sf::FloatRect& UniformGrid::getArea() const
+{return this->area;}
+
+size_t UniformGrid::columnOf(float x) const
+{
+    float column = std::floor((x - this->area.left) / this->cellSize);
+    return static_cast<size_t>(std::clamp(column, 0.f, this->columns - 1.f));
+}
+
+size_t UniformGrid::rowOf(float y) const
+{
+    float row = std::floor((y - this->area.top) / this->cellSize);
+    return static_cast<size_t>(std::clamp(row, 0.f, this->rows - 1.f));
+}
+
+size_t UniformGrid::cellBegin(size_t cell) const
+{return this->cellStarts[cell];}
+
+size_t UniformGrid::cellEnd(size_t cell) const
+{return this->cellStarts[cell + 1];}
+
+const std::vector<uint32_t>& UniformGrid::getSortedIndices() const
+{return this->sortedIndices;}
+
+const std::vector<sf::Vector2f>& UniformGrid::getSortedPoints() const
+{return this->sortedPoints;}
@@ -0,0 +1,162 @@
+#ifndef UNIFORM_GRID_HPP
+#define UNIFORM_GRID_HPP
+
+// For positions and bounds
+#include <SFML/Graphics.hpp>
+
+// For fixed-width indices
+#include <cstdint>
+
+// For walking cells along rays
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+// For the points to bin
+#include <span>
+
+// For the binned elements
+#include <vector>
+
+// Square cells over a fixed area, with points counting-sorted by cell so
+// that every cell's points sit next to each other. Points outside the area
+// are clamped into the border cells
+class UniformGrid
+{
+    public:
+        // Default-construct an empty grid
+        UniformGrid();
+
+        // Bin every point into cells of the given size over the area
+        void build(std::span<const sf::Vector2f> points, 
+            const sf::FloatRect& grid_area, float cell_size);
+
+        // Get the grid layout
+        float getCellSize() const;
+        size_t getColumns() const;
+        size_t getRows() const;
+        const sf::FloatRect& getArea() const;
+
+        // Get the column or row holding a coordinate, clamped to the grid
+        size_t columnOf(float x) const;
+        size_t rowOf(float y) const;
+
+        // Get the range of a cell, given as row * columns + column, within
+        // the sorted points
+        size_t cellBegin(size_t cell) const;
+        size_t cellEnd(size_t cell) const;
+
+        // Get the original index and position of every point, sorted by cell
+        const std::vector<uint32_t>& getSortedIndices() const;
+        const std::vector<sf::Vector2f>& getSortedPoints() const;
+
+        // Call visit(first, last) for every row of the cells overlapping
+        // the box from lowest to highest, clamped to the grid, with first
+        // and last the cells at either end of the row. Cells of a row are
+        // contiguous in the sorted order, so its points run from
+        // cellBegin(first) to cellEnd(last)
+        template <typename Visit>
+        void forEachRowRun(const sf::Vector2f& lowest, const sf::Vector2f& highest, 
+            Visit&& visit) const
+        {
+            const size_t firstColumn = this->columnOf(lowest.x);
+            const size_t lastColumn = this->columnOf(highest.x);
+            const size_t lastRow = this->rowOf(highest.y);
+
+            for (size_t row = this->rowOf(lowest.y); row <= lastRow; ++row)
+                visit(row * this->columns + firstColumn, row * this->columns + lastColumn);
+        }
+
+        // Call visit(column, row, enter, exit) for every cell a segment
+        // crosses, in order from its origin, with [enter, exit] the part of
+        // the segment within the cell as distances along it. The direction
+        // must be of unit length. Only the cells crossed are visited, one
+        // grid line at a time, and the part outside the area is left out
+        template <typename Visit>
+        void forEachCellAlongRay(const sf::Vector2f& origin, 
+            const sf::Vector2f& direction, float length, Visit&& visit) const
+        {
+            const float infinity = std::numeric_limits<float>::infinity();
+            const float origins[] = {origin.x, origin.y};
+            const float directions[] = {direction.x, direction.y};
+            const float lows[] = {this->area.left, this->area.top};
+            const float highs[] = {this->area.left + this->area.width, 
+                this->area.top + this->area.height};
+
+            // Clip the segment to the area, one axis at a time
+            float enter = 0, exit = length;
+            for (size_t axis = 0; axis < 2; ++axis)
+            {
+                if (directions[axis] == 0)
+                {
+                    if (origins[axis] < lows[axis] || origins[axis] > highs[axis])
+                        return;
+
+                    continue;
+                }
+
+                float toLow = (lows[axis] - origins[axis]) / directions[axis];
+                float toHigh = (highs[axis] - origins[axis]) / directions[axis];
+                enter = std::max(enter, std::min(toLow, toHigh));
+                exit = std::min(exit, std::max(toLow, toHigh));
+            }
+
+            if (enter > exit || this->columns == 0)
+                return;
+
+            // Start in the cell holding the entry point, then step over
+            // whichever grid line comes first along the segment
+            size_t cells[] = {this->columnOf(origin.x + direction.x * enter),
+                this->rowOf(origin.y + direction.y * enter)};
+            const size_t counts[] = {this->columns, this->rows};
+
+            float nextLine[2], lineSpacing[2];
+            for (size_t axis = 0; axis < 2; ++axis)
+            {
+                if (directions[axis] == 0)
+                {
+                    nextLine[axis] = lineSpacing[axis] = infinity;
+                    continue;
+                }
+
+                float line = lows[axis] 
+                    + (cells[axis] + (directions[axis] > 0)) * this->cellSize;
+                nextLine[axis] = (line - origins[axis]) / directions[axis];
+                lineSpacing[axis] = this->cellSize / std::abs(directions[axis]);
+            }
+
+            while (true)
+            {
+                size_t axis = nextLine[0] < nextLine[1] ? 0 : 1;
+                float cellExit = std::min(nextLine[axis], exit);
+                visit(cells[0], cells[1], enter, cellExit);
+
+                if (cellExit >= exit)
+                    return;
+
+                // Leaving the grid past its last line
+                if (directions[axis] > 0 ? cells[axis] + 1 >= counts[axis] : cells[axis] == 0)
+                    return;
+
+                cells[axis] += directions[axis] > 0 ? 1 : -1;
+                enter = cellExit;
+                nextLine[axis] += lineSpacing[axis];
+            }
+        }
+
+    private:
+        sf::FloatRect area;
+        float cellSize;
+        size_t columns;
+        size_t rows;
+
+        // Every point's cell, and where each cell's run starts. The last
+        // entry holds the amount of points
+        std::vector<uint32_t> pointCells;
+        std::vector<uint32_t> cellStarts;
+
+        std::vector<uint32_t> sortedIndices;
+        std::vector<sf::Vector2f> sortedPoints;
+};
+
+#endif
@@ -0,0 +1,88 @@
+#include "UniformGrid3D.hpp"
+
+// For clamping cells
+#include <algorithm>
+#include <cmath>
+
+// Constructor
+
+UniformGrid3D::UniformGrid3D() :
+cellSize(1), cellCounts(0, 0, 0)
+{}
+
+// Building
+
+void UniformGrid3D::build(std::span<const sf::Vector3f> points,
+    const sf::Vector3f& box_corner, const sf::Vector3f& box_size, float cell_size)
+{
+    this->corner = box_corner;
+    this->cellSize = cell_size;
+    this->cellCounts.x = std::max(1.f, std::ceil(box_size.x / cell_size));
+    this->cellCounts.y = std::max(1.f, std::ceil(box_size.y / cell_size));
+    this->cellCounts.z = std::max(1.f, std::ceil(box_size.z / cell_size));
+
+    size_t pointCount = points.size();
+    this->pointCells.resize(pointCount);
+    this->sortedIndices.resize(pointCount);
+    this->sortedPoints.resize(pointCount);
+    this->cellStarts.assign(this->cellCounts.x * this->cellCounts.y * this->cellCounts.z + 1, 0);
+
+    // Counting sort: count, prefix-sum, then scatter
+    for (size_t pointIter = 0; pointIter < pointCount; ++pointIter)
+    {
+        sf::Vector3<size_t> cell = this->cellOf(points[pointIter]);
+        uint32_t index = this->cellIndex(cell.x, cell.y, cell.z);
+
+        this->pointCells[pointIter] = index;
+        ++this->cellStarts[index];
+    }
+
+    for (size_t cellIter = 1; cellIter < this->cellStarts.size(); ++cellIter)
+        this->cellStarts[cellIter] += this->cellStarts[cellIter - 1];
+
+    // Scatter backwards, leaving every entry at its cell's start and points
+    // in index order within each cell
+    for (size_t pointIter = pointCount; pointIter-- > 0;)
+    {
+        uint32_t sorted = --this->cellStarts[this->pointCells[pointIter]];
+        this->sortedIndices[sorted] = pointIter;
+        this->sortedPoints[sorted] = points[pointIter];
+    }
+}
+
+// Getters
+
+float UniformGrid3D::getCellSize() const
+{return this->cellSize;}
+
+const sf::Vector3<size_t>& UniformGrid3D::getCellCounts() const
+{return this->cellCounts;}
+
+sf::Vector3<size_t> UniformGrid3D::cellOf(const sf::Vector3f& point) const
+{
+    return sf::Vector3<size_t>
+        (axisCell(point.x - this->corner.x, this->cellSize, this->cellCounts.x),
+        axisCell(point.y - this->corner.y, this->cellSize, this->cellCounts.y),
+        axisCell(point.z - this->corner.z, this->cellSize, this->cellCounts.z));
+}
+
+size_t UniformGrid3D::cellIndex(size_t column, size_t row, size_t layer) const
+{return (layer * this->cellCounts.y + row) * this->cellCounts.x + column;}
+
+size_t UniformGrid3D::cellBegin(size_t cell) const
+{return this->cellStarts[cell];}
+
+size_t UniformGrid3D::cellEnd(size_t cell) const
+{return this->cellStarts[cell + 1];}
+
+const std::vector<uint32_t>& UniformGrid3D::getSortedIndices() const
+{return this->sortedIndices;}
+
+const std::vector<sf::Vector3f>& UniformGrid3D::getSortedPoints() const
+{return this->sortedPoints;}
+
+size_t UniformGrid3D::axisCell(float offset, float cell_size, size_t cell_count)
+{
+    float cell = std::floor(offset / cell_size);
+    return static_cast<size_t>(std::clamp(cell, 0.f, cell_count - 1.f));
+}
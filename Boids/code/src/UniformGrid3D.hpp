@@ -0,0 +1,82 @@
+#ifndef UNIFORM_GRID_3D_HPP
+#define UNIFORM_GRID_3D_HPP
+
+// For positions
+#include <SFML/Graphics.hpp>
+
+// For fixed-width indices
+#include <cstdint>
+
+// For the points to bin
+#include <span>
+
+// For the binned elements
+#include <vector>
+
+// Cubic cells over a fixed box, with points counting-sorted by cell so that
+// every cell's points sit next to each other. Points outside the box are
+// clamped into the border cells. The volumetric counterpart of UniformGrid
+class UniformGrid3D
+{
+    public:
+        // Default-construct an empty grid
+        UniformGrid3D();
+
+        // Bin every point into cells of the given size over the box
+        // starting at a corner
+        void build(std::span<const sf::Vector3f> points,
+            const sf::Vector3f& box_corner, const sf::Vector3f& box_size, float cell_size);
+
+        // Get the grid layout, as columns, rows and layers
+        float getCellSize() const;
+        const sf::Vector3<size_t>& getCellCounts() const;
+
+        // Get the column, row and layer holding a point, clamped to the grid
+        sf::Vector3<size_t> cellOf(const sf::Vector3f& point) const;
+
+        // Get the index of a cell, given as (layer * rows + row) * columns
+        // + column
+        size_t cellIndex(size_t column, size_t row, size_t layer) const;
+
+        // Get the range of a cell within the sorted points
+        size_t cellBegin(size_t cell) const;
+        size_t cellEnd(size_t cell) const;
+
+        // Get the original index and position of every point, sorted by cell
+        const std::vector<uint32_t>& getSortedIndices() const;
+        const std::vector<sf::Vector3f>& getSortedPoints() const;
+
+        // Call visit(first, last) for every row of every layer of the cells
+        // overlapping the box from lowest to highest, clamped to the grid,
+        // as UniformGrid::forEachRowRun does
+        template <typename Visit>
+        void forEachRowRun(const sf::Vector3f& lowest, const sf::Vector3f& highest, 
+            Visit&& visit) const
+        {
+            const sf::Vector3<size_t> first = this->cellOf(lowest);
+            const sf::Vector3<size_t> last = this->cellOf(highest);
+
+            for (size_t layer = first.z; layer <= last.z; ++layer)
+                for (size_t row = first.y; row <= last.y; ++row)
+                    visit(this->cellIndex(first.x, row, layer), 
+                        this->cellIndex(last.x, row, layer));
+        }
+
+    private:
+        sf::Vector3f corner;
+        float cellSize;
+        sf::Vector3<size_t> cellCounts;
+
+        // Every point's cell, and where each cell's run starts. The last
+        // entry holds the amount of points
+        std::vector<uint32_t> pointCells;
+        std::vector<uint32_t> cellStarts;
+
+        std::vector<uint32_t> sortedIndices;
+        std::vector<sf::Vector3f> sortedPoints;
+
+        // Get the cell along one axis holding a coordinate, clamped
+        static size_t axisCell(float offset, float cell_size, size_t cell_count);
+};
+
+#endif
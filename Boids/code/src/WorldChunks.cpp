@@ -0,0 +1,98 @@
+#include "WorldChunks.hpp"
+
+// For boid positions
+#include "BoidStorage.hpp"
+
+// For chunk coordinates
+#include <algorithm>
+#include <cmath>
+
+// Constructor
+
+WorldChunks::WorldChunks() :
+enabled(false), chunkSize(256), interestMargin(128), distantInterval(4),
+hasInterest(false), nearChunks(0), totalChunks(0)
+{}
+
+// Setters
+
+void WorldChunks::setInterest(const sf::FloatRect& interest_area)
+{
+    std::lock_guard<std::mutex> lock(this->interestMutex);
+    this->interest = interest_area;
+    this->hasInterest = true;
+}
+
+// Classification
+
+size_t WorldChunks::classify(const BoidStorage& boids, const sf::FloatRect& bounds,
+    size_t step, std::span<float> time_scales)
+{
+    sf::FloatRect near;
+    bool anyInterest;
+    {
+        std::lock_guard<std::mutex> lock(this->interestMutex);
+        near = this->interest;
+        anyInterest = this->hasInterest;
+    }
+
+    near.left -= this->interestMargin;
+    near.top -= this->interestMargin;
+    near.width += 2 * this->interestMargin;
+    near.height += 2 * this->interestMargin;
+
+    size_t columns = std::max<size_t>(std::ceil(bounds.width / this->chunkSize), 1);
+    size_t rows = std::max<size_t>(std::ceil(bounds.height / this->chunkSize), 1);
+
+    // Chunks touching the near area, or every chunk with no area set yet
+    this->totalChunks = columns * rows;
+    this->nearChunks = 0;
+    this->nearness.assign(this->totalChunks, !anyInterest);
+
+    if (anyInterest)
+        for (size_t row = 0; row < rows; ++row)
+            for (size_t column = 0; column < columns; ++column)
+            {
+                sf::FloatRect chunk(bounds.left + column * this->chunkSize,
+                    bounds.top + row * this->chunkSize, this->chunkSize, this->chunkSize);
+
+                if (chunk.intersects(near))
+                    this->nearness[row * columns + column] = true;
+            }
+
+    this->nearChunks = std::count(this->nearness.begin(), this->nearness.end(), true);
+
+    // Distant chunks are due in turns, by chunk index
+    size_t interval = std::max<size_t>(this->distantInterval, 1);
+
+    size_t stepped = 0;
+    for (size_t boidIter = 0; boidIter < boids.size(); ++boidIter)
+    {
+        const sf::Vector2f& position = boids[boidIter].getPosition();
+        float column = std::floor((position.x - bounds.left) / this->chunkSize);
+        float row = std::floor((position.y - bounds.top) / this->chunkSize);
+
+        size_t chunk = 
+            static_cast<size_t>(std::clamp(row, 0.f, rows - 1.f)) * columns
+            + static_cast<size_t>(std::clamp(column, 0.f, columns - 1.f));
+
+        if (this->nearness[chunk])
+            time_scales[boidIter] = 1;
+        else if ((step + chunk) % interval == 0)
+            time_scales[boidIter] = interval;
+        else
+            time_scales[boidIter] = 0;
+
+        stepped += time_scales[boidIter] != 0;
+    }
+
+    return stepped;
+}
+
+// Getters
+
+size_t WorldChunks::getNearChunks() const
+{return this->nearChunks;}
+
+size_t WorldChunks::getTotalChunks() const
+{return this->totalChunks;}
@@ -0,0 +1,69 @@
+#ifndef WORLD_CHUNKS_HPP
+#define WORLD_CHUNKS_HPP
+
+// For the interest area and bounds
+#include <SFML/Graphics.hpp>
+
+// For guarding the interest area
+#include <mutex>
+
+// For per-boid time scales
+#include <span>
+#include <vector>
+
+// Forward declaration, only handled through references
+class BoidStorage;
+
+// Level of detail by region. The world is split into square chunks, and
+// boids in chunks near the area of interest, usually what the camera sees,
+// are simulated every step. Boids in distant chunks only get stepped every
+// distantInterval steps, each covering that many steps at once, so the
+// cost of steering and moving tracks what's around the area of interest
+// rather than the whole population. Distant chunks take turns, so their
+// cost is spread evenly over steps
+class WorldChunks
+{
+    public:
+        // Whether boids in distant chunks are simulated at a reduced rate
+        bool enabled;
+
+        // Side of every chunk
+        float chunkSize;
+
+        // Distance past the area of interest within which chunks still
+        // count as near
+        float interestMargin;
+
+        // Steps between updates of boids in distant chunks
+        size_t distantInterval;
+
+        // Default-construct disabled, with everything counted as near
+        WorldChunks();
+
+        // Set the area of interest. May be called from any thread
+        void setInterest(const sf::FloatRect& interest_area);
+
+        // Get each boid's time scale for the given step: one for near boids,
+        // distantInterval for distant boids due this step, and zero for those
+        // skipping it, into a buffer holding one per boid. Get the amount of
+        // boids stepped
+        size_t classify(const BoidStorage& boids, const sf::FloatRect& bounds,
+            size_t step, std::span<float> time_scales);
+
+        // Get the chunk counts as of the latest classification
+        size_t getNearChunks() const;
+        size_t getTotalChunks() const;
+
+    private:
+        sf::FloatRect interest;
+        bool hasInterest;
+        std::mutex interestMutex;
+
+        size_t nearChunks;
+        size_t totalChunks;
+
+        // Per-chunk nearness, row after row
+        std::vector<bool> nearness;
+};
+
+#endif
@@ -0,0 +1,296 @@
+#include "WorldHistory.hpp"
+
+// For finding segments and clamping exponents
+#include <algorithm>
+
+// For quanta
+#include <cmath>
+
+// Range of the quanta steps may pick, as powers of two. Changes too large
+// for the coarsest one are always kept exactly
+static constexpr int minExponent = -24;
+static constexpr int maxExponent = 24;
+static constexpr size_t exponentSpan = maxExponent - minExponent + 2;
+
+// At most one boid in this many is kept exactly instead of coarsening a
+// step's quantum for everyone
+static constexpr size_t escapeShare = 64;
+
+// Get the smallest power of two a change fits in 127 steps of
+static int8_t requiredExponent(float magnitude)
+{
+    if (magnitude == 0)
+        return minExponent;
+
+    int exponent;
+    std::frexp(magnitude / 127.f, &exponent);
+
+    // NaNs and changes beyond every quantum land past the coarsest one
+    if (!(magnitude < INFINITY) || exponent > maxExponent)
+        return maxExponent + 1;
+
+    return std::max(exponent, minExponent);
+}
+
+// Get the smallest exponent that leaves at most the allowed amount of
+// changes needing a larger one
+static int8_t pickExponent(const std::vector<int8_t>& exponents, size_t allowed)
+{
+    size_t counts[exponentSpan] = {};
+    for (int8_t exponent : exponents)
+        ++counts[exponent - minExponent];
+
+    size_t above = counts[exponentSpan - 1];
+    int chosen = maxExponent;
+    for (int exponent = maxExponent; exponent > minExponent; --exponent)
+    {
+        above += counts[exponent - minExponent];
+        if (above > allowed)
+            break;
+
+        chosen = exponent - 1;
+    }
+
+    return chosen;
+}
+
+// Get a change in quantum steps
+static int8_t quantize(float change, float quantum)
+{return std::clamp<long>(std::lround(change / quantum), -127, 127);}
+
+// Bring a heading back into [0, 360)
+static float wrapHeading(float heading)
+{
+    if (heading < 0)
+        heading += 360;
+    else if (heading >= 360)
+        heading -= 360;
+
+    return heading;
+}
+
+// Constructor
+
+WorldHistory::WorldHistory() :
+enabled(false), keyframeInterval(64), memoryCap(size_t(512) << 20),
+memoryBytes(0), needsKeyframe(true)
+{}
+
+// Recording
+
+void WorldHistory::record(size_t step, const BoidStorage& boids)
+{
+    // Going back in time rewrites everything that followed
+    if (!this->empty() && step <= this->getLastStep())
+        this->truncate(step);
+
+    bool keyframe = this->needsKeyframe || this->empty()
+        || step != this->getLastStep() + 1
+        || this->segments.back().frames.size() + 1 >= this->keyframeInterval
+        || this->segments.back().ids.size() != boids.size();
+
+    // So do boids that were spawned, despawned or moved around
+    for (size_t boidIter = 0; !keyframe && boidIter < boids.size(); ++boidIter)
+        keyframe = boids.getId(boidIter) != this->segments.back().ids[boidIter];
+
+    if (keyframe)
+        this->recordKeyframe(step, boids);
+    else
+        this->recordDeltas(boids);
+
+    while (this->memoryBytes > this->memoryCap && this->segments.size() > 1)
+    {
+        this->memoryBytes -= this->segments.front().bytes;
+        this->segments.pop_front();
+    }
+}
+
+void WorldHistory::recordKeyframe(size_t step, const BoidStorage& boids)
+{
+    size_t boidCount = boids.size();
+
+    Segment segment;
+    segment.firstStep = step;
+    segment.ids.resize(boidCount);
+    segment.positions.resize(boidCount);
+    segment.headings.resize(boidCount);
+    for (size_t boidIter = 0; boidIter < boidCount; ++boidIter)
+    {
+        segment.ids[boidIter] = boids.getId(boidIter);
+        segment.positions[boidIter] = boids[boidIter].getPosition();
+        segment.headings[boidIter] = boids[boidIter].getHeading();
+    }
+
+    segment.bytes = sizeof(Segment) + boidCount * (sizeof(BoidStorage::BoidId)
+        + sizeof(sf::Vector2f) + sizeof(float));
+
+    this->lastPositions = segment.positions;
+    this->lastHeadings = segment.headings;
+    this->needsKeyframe = false;
+
+    this->memoryBytes += segment.bytes;
+    this->segments.push_back(std::move(segment));
+}
+
+void WorldHistory::recordDeltas(const BoidStorage& boids)
+{
+    size_t boidCount = boids.size();
+
+    // Find the quanta fitting most of this step's changes
+    this->positionExponents.resize(boidCount);
+    this->headingExponents.resize(boidCount);
+    for (size_t boidIter = 0; boidIter < boidCount; ++boidIter)
+    {
+        sf::Vector2f move = boids[boidIter].getPosition() - this->lastPositions[boidIter];
+        float turn = std::remainder(boids[boidIter].getHeading() - this->lastHeadings[boidIter], 360.f);
+
+        this->positionExponents[boidIter] =
+            requiredExponent(std::max(std::abs(move.x), std::abs(move.y)));
+        this->headingExponents[boidIter] = requiredExponent(std::abs(turn));
+    }
+
+    size_t allowed = boidCount / escapeShare;
+
+    DeltaFrame frame;
+    frame.positionExponent = pickExponent(this->positionExponents, allowed);
+    frame.headingExponent = pickExponent(this->headingExponents, allowed);
+    frame.deltas.resize(boidCount * 3);
+
+    float positionQuantum = std::ldexp(1.f, frame.positionExponent);
+    float headingQuantum = std::ldexp(1.f, frame.headingExponent);
+
+    for (size_t boidIter = 0; boidIter < boidCount; ++boidIter)
+    {
+        const Boid& boid = boids[boidIter];
+
+        // Changes that don't fit are kept exactly, with zero deltas
+        if (this->positionExponents[boidIter] > frame.positionExponent
+            || this->headingExponents[boidIter] > frame.headingExponent)
+        {
+            frame.escapes.push_back({static_cast<uint32_t>(boidIter),
+                boid.getPosition(), boid.getHeading()});
+            continue;
+        }
+
+        sf::Vector2f move = boid.getPosition() - this->lastPositions[boidIter];
+        float turn = std::remainder(boid.getHeading() - this->lastHeadings[boidIter], 360.f);
+
+        int8_t* deltas = &frame.deltas[boidIter * 3];
+        deltas[0] = quantize(move.x, positionQuantum);
+        deltas[1] = quantize(move.y, positionQuantum);
+        deltas[2] = quantize(turn, headingQuantum);
+    }
+
+    frame.escapes.shrink_to_fit();
+
+    // Follow what seeking will reconstruct, not the real state
+    applyFrame(frame, this->lastPositions, this->lastHeadings);
+
+    Segment& segment = this->segments.back();
+    size_t frameBytes = getFrameBytes(frame);
+    segment.bytes += frameBytes;
+    this->memoryBytes += frameBytes;
+    segment.frames.push_back(std::move(frame));
+}
+
+void WorldHistory::truncate(size_t step)
+{
+    while (!this->segments.empty() && this->segments.back().firstStep >= step)
+    {
+        this->memoryBytes -= this->segments.back().bytes;
+        this->segments.pop_back();
+    }
+
+    if (!this->segments.empty())
+    {
+        Segment& segment = this->segments.back();
+        size_t kept = step - segment.firstStep - 1;
+        for (size_t frameIter = kept; frameIter < segment.frames.size(); ++frameIter)
+        {
+            size_t frameBytes = getFrameBytes(segment.frames[frameIter]);
+            segment.bytes -= frameBytes;
+            this->memoryBytes -= frameBytes;
+        }
+
+        segment.frames.erase(segment.frames.begin() + kept, segment.frames.end());
+    }
+
+    this->needsKeyframe = true;
+}
+
+void WorldHistory::clear()
+{
+    this->segments.clear();
+    this->memoryBytes = 0;
+    this->needsKeyframe = true;
+}
+
+// Seeking
+
+bool WorldHistory::restore(size_t step, std::vector<BoidStorage::BoidId>& ids,
+    std::vector<sf::Vector2f>& positions, std::vector<float>& headings) const
+{
+    if (this->empty() || step < this->getFirstStep() || step > this->getLastStep())
+        return false;
+
+    // Latest keyframe at or before the step
+    auto segment = std::upper_bound(this->segments.begin(), this->segments.end(), step,
+        [](size_t sought_step, const Segment& later) {return sought_step < later.firstStep;});
+    --segment;
+
+    // Steps where recording skipped ahead were never recorded
+    size_t replayed = step - segment->firstStep;
+    if (replayed > segment->frames.size())
+        return false;
+
+    ids = segment->ids;
+    positions = segment->positions;
+    headings = segment->headings;
+    for (size_t frameIter = 0; frameIter < replayed; ++frameIter)
+        applyFrame(segment->frames[frameIter], positions, headings);
+
+    return true;
+}
+
+void WorldHistory::applyFrame(const DeltaFrame& frame,
+    std::vector<sf::Vector2f>& positions, std::vector<float>& headings)
+{
+    float positionQuantum = std::ldexp(1.f, frame.positionExponent);
+    float headingQuantum = std::ldexp(1.f, frame.headingExponent);
+
+    for (size_t boidIter = 0; boidIter < positions.size(); ++boidIter)
+    {
+        const int8_t* deltas = &frame.deltas[boidIter * 3];
+        positions[boidIter].x += deltas[0] * positionQuantum;
+        positions[boidIter].y += deltas[1] * positionQuantum;
+        headings[boidIter] = wrapHeading(headings[boidIter] + deltas[2] * headingQuantum);
+    }
+
+    for (const Escape& escape : frame.escapes)
+    {
+        positions[escape.index] = escape.position;
+        headings[escape.index] = escape.heading;
+    }
+}
+
+// Getters
+
+bool WorldHistory::empty() const
+{return this->segments.empty();}
+
+size_t WorldHistory::getFirstStep() const
+{return this->empty() ? 0 : this->segments.front().firstStep;}
+
+size_t WorldHistory::getLastStep() const
+{return this->empty() ? 0 : this->segments.back().firstStep + this->segments.back().frames.size();}
+
+size_t WorldHistory::getMemoryBytes() const
+{
+    return this->memoryBytes 
+        + this->lastPositions.capacity() * sizeof(sf::Vector2f)
+        + this->lastHeadings.capacity() * sizeof(float)
+        + this->positionExponents.capacity() + this->headingExponents.capacity();
+}
+
+size_t WorldHistory::getFrameBytes(const DeltaFrame& frame)
+{return sizeof(DeltaFrame) + frame.deltas.capacity() + frame.escapes.capacity() * sizeof(Escape);}
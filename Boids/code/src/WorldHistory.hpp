@@ -0,0 +1,130 @@
+#ifndef WORLD_HISTORY_HPP
+#define WORLD_HISTORY_HPP
+
+// For positions
+#include <SFML/Graphics.hpp>
+
+// For quantized deltas
+#include <cstdint>
+
+// For segments, oldest first
+#include <deque>
+
+// For per-boid state
+#include <vector>
+
+// For boid ids
+#include "BoidStorage.hpp"
+
+// Past positions and headings of every boid, for going back in time. Every
+// keyframeInterval steps a full keyframe is kept, and the steps in between
+// only keep each boid's change since the step before, quantized to a byte
+// per component. Every step's changes pick their own power-of-two quanta,
+// fitting all but a few boids, and the rest, like boids wrapping around,
+// are kept exactly. Changes are taken against the reconstructed state
+// rather than the real one, so quantization errors never add up. Seeking
+// restores the nearest keyframe at or before a step and replays changes
+// from there. Whole keyframes and their changes are evicted, oldest first,
+// once the history holds more than memoryCap bytes
+class WorldHistory
+{
+    public:
+        // Whether every step is recorded
+        bool enabled;
+
+        // Steps between keyframes, one for keyframes only
+        size_t keyframeInterval;
+
+        // Memory the history may hold, in bytes. The keyframe being
+        // recorded onto is never evicted
+        size_t memoryCap;
+
+        // Default-construct disabled and empty
+        WorldHistory();
+
+        // Record the state of every boid after the given step. Recording a
+        // step that was already recorded drops it and everything after
+        void record(size_t step, const BoidStorage& boids);
+
+        // Get the ids, positions and headings every boid had after the
+        // given step. False if it isn't in the history
+        bool restore(size_t step, std::vector<BoidStorage::BoidId>& ids,
+            std::vector<sf::Vector2f>& positions, std::vector<float>& headings) const;
+
+        // Drop every recorded step
+        void clear();
+
+        // Check whether any step was recorded
+        bool empty() const;
+
+        // Get the oldest and latest recorded steps
+        size_t getFirstStep() const;
+        size_t getLastStep() const;
+
+        // Get the memory held by the history
+        size_t getMemoryBytes() const;
+
+    private:
+        // Boid kept exactly within a step of changes
+        struct Escape
+        {
+            uint32_t index;
+            sf::Vector2f position;
+            float heading;
+        };
+
+        // Changes of every boid over one step, as (x, y, heading) byte
+        // triplets in units of 2 ^ exponent
+        struct DeltaFrame
+        {
+            int8_t positionExponent;
+            int8_t headingExponent;
+            std::vector<int8_t> deltas;
+            std::vector<Escape> escapes;
+        };
+
+        // A keyframe and the changes recorded on top of it
+        struct Segment
+        {
+            size_t firstStep;
+            std::vector<BoidStorage::BoidId> ids;
+            std::vector<sf::Vector2f> positions;
+            std::vector<float> headings;
+            std::vector<DeltaFrame> frames;
+            size_t bytes;
+        };
+
+        std::deque<Segment> segments;
+        size_t memoryBytes;
+
+        // Reconstructed state after the latest recorded step, which changes
+        // are taken against
+        std::vector<sf::Vector2f> lastPositions;
+        std::vector<float> lastHeadings;
+
+        // Set once the reconstructed state no longer follows the latest
+        // recorded step
+        bool needsKeyframe;
+
+        // Per-boid exponents, while picking a step's quanta
+        std::vector<int8_t> positionExponents;
+        std::vector<int8_t> headingExponents;
+
+        // Start a new segment from the current state
+        void recordKeyframe(size_t step, const BoidStorage& boids);
+
+        // Append the changes since the latest recorded step
+        void recordDeltas(const BoidStorage& boids);
+
+        // Drop the given step and everything after
+        void truncate(size_t step);
+
+        // Get the memory held by a step of changes
+        static size_t getFrameBytes(const DeltaFrame& frame);
+
+        // Apply a step of changes to a reconstructed state
+        static void applyFrame(const DeltaFrame& frame,
+            std::vector<sf::Vector2f>& positions, std::vector<float>& headings);
+};
+
+#endif
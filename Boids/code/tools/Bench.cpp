@@ -0,0 +1,266 @@
+// Headless scaling benchmark, compared against a stored baseline
+// Usage: Bench [--baseline path] [--output path] [--threshold fraction]
+//              [--repeats count] [--max-boids count] [--deterministic]
+//              [--update] [--case name]
+// Every case runs in a process of its own, Bench calling itself with
+// --case, so peak memory and allocations are those of that case alone.
+// Each case runs --repeats times, keeping the run with the fastest median
+// step, since the rest of the machine only ever slows runs down. Exits
+// with 1 when any case's median step got slower than the threshold
+// allows, has no baseline, or allocated on the heap once warmed up in any
+// run. Allocations are only checked over the worlds the cases step: the
+// plain sweep and the variants set up by ScalingBenchmark. Trails, the
+// heatmap, history, trajectory recording and auto-tuning are outside of
+// that guarantee
+
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <fstream>
+#include <new>
+#include <string>
+
+#ifdef _WIN32
+    #include <malloc.h>
+#endif
+
+#include "AllocationCounter.hpp"
+#include "ScalingBenchmark.hpp"
+
+// Count every heap allocation of the process, for steady-state steps
+void* operator new(size_t bytes)
+{
+    AllocationCounter::record();
+    if (void* memory = std::malloc(bytes ? bytes : 1))
+        return memory;
+
+    throw std::bad_alloc();
+}
+
+void* operator new(size_t bytes, std::align_val_t alignment)
+{
+    AllocationCounter::record();
+    size_t align = static_cast<size_t>(alignment);
+#ifdef _WIN32
+    // Windows has no aligned_alloc, and its aligned blocks need freeing apart
+    if (void* memory = _aligned_malloc(bytes ? bytes : 1, align))
+        return memory;
+#else
+    if (void* memory = std::aligned_alloc(align, (bytes + align - 1) / align * align))
+        return memory;
+#endif
+
+    throw std::bad_alloc();
+}
+
+// Free a block from the aligned operator new
+static void freeAligned(void* memory)
+{
+#ifdef _WIN32
+    _aligned_free(memory);
+#else
+    std::free(memory);
+#endif
+}
+
+void operator delete(void* memory) noexcept
+{std::free(memory);}
+
+void operator delete(void* memory, size_t) noexcept
+{std::free(memory);}
+
+void operator delete(void* memory, std::align_val_t) noexcept
+{freeAligned(memory);}
+
+void operator delete(void* memory, size_t, std::align_val_t) noexcept
+{freeAligned(memory);}
+
+// Run a single case in this process, writing its result to the given file
+static int runCase(const ScalingBenchmark& benchmark, const std::string& case_name,
+    const std::string& output_path)
+{
+    std::vector<BenchmarkCase> cases = benchmark.buildCases();
+    auto benchCase = std::find_if(cases.begin(), cases.end(),
+        [&case_name](const BenchmarkCase& listed) {return listed.name == case_name;});
+
+    if (benchCase == cases.end())
+    {
+        std::cerr << "Unknown case " << case_name << std::endl;
+        return 2;
+    }
+
+    if (!ScalingBenchmark::writeJson(output_path, {benchmark.run(*benchCase)}))
+    {
+        std::cerr << "Could not write " << output_path << std::endl;
+        return 2;
+    }
+
+    return 0;
+}
+
+// Run a case in a fresh process of this same tool, appending its result.
+// False if the process failed or left no result behind
+static bool runCaseProcess(const std::string& tool_path, const ScalingBenchmark& benchmark,
+    const std::string& case_name, const std::string& output_path,
+    std::vector<BenchmarkResult>& results)
+{
+    std::remove(output_path.c_str());
+
+    std::string command = "\"" + tool_path + "\" --case " + case_name 
+        + " --output \"" + output_path + "\"" 
+        + (benchmark.deterministic ? " --deterministic" : "");
+#ifdef _WIN32
+    // cmd strips the outermost pair of quotes off the whole line
+    command = "\"" + command + "\"";
+#endif
+
+    size_t resultCount = results.size();
+    if (std::system(command.c_str()) != 0)
+        return false;
+
+    bool read = ScalingBenchmark::readJson(output_path, results);
+    std::remove(output_path.c_str());
+    return read && results.size() == resultCount + 1;
+}
+
+int main(int argc, char* argv[])
+{
+    std::string baselinePath = "bench/baseline.json";
+    std::string outputPath = "bench.json";
+    std::string caseName;
+    // Across three runs of the whole benchmark on a busy single-core
+    // machine, a case's fastest median out of 5 moved by up to 40%, and
+    // by under 30% for all but one case. Fewer repeats moved it by up to
+    // 50%, so a lower threshold would mostly flag noise
+    double threshold = 0.4;
+    size_t repeats = 5;
+    bool updateBaseline = false;
+
+    ScalingBenchmark benchmark;
+
+    for (int argIter = 1; argIter < argc; ++argIter)
+    {
+        bool hasValue = argIter + 1 < argc;
+
+        if (!std::strcmp(argv[argIter], "--baseline") && hasValue)
+            baselinePath = argv[++argIter];
+        else if (!std::strcmp(argv[argIter], "--output") && hasValue)
+            outputPath = argv[++argIter];
+        else if (!std::strcmp(argv[argIter], "--threshold") && hasValue)
+            threshold = std::stod(argv[++argIter]);
+        else if (!std::strcmp(argv[argIter], "--repeats") && hasValue)
+            repeats = std::max<size_t>(std::stoul(argv[++argIter]), 1);
+        else if (!std::strcmp(argv[argIter], "--max-boids") && hasValue)
+            benchmark.maxBoidCount = std::stoul(argv[++argIter]);
+        else if (!std::strcmp(argv[argIter], "--deterministic"))
+            benchmark.deterministic = true;
+        else if (!std::strcmp(argv[argIter], "--update"))
+            updateBaseline = true;
+        else if (!std::strcmp(argv[argIter], "--case") && hasValue)
+            caseName = argv[++argIter];
+        else
+        {
+            std::cerr << "Unknown argument " << argv[argIter] << std::endl;
+            return 2;
+        }
+    }
+
+    if (!caseName.empty())
+        return runCase(benchmark, caseName, outputPath);
+
+    // Cases report through a file next to the output
+    const std::string casePath = outputPath + ".case";
+
+    std::vector<BenchmarkResult> results, runs;
+    for (const BenchmarkCase& benchCase : benchmark.buildCases())
+    {
+        runs.clear();
+        for (size_t repeatIter = 0; repeatIter < repeats; ++repeatIter)
+            if (!runCaseProcess(argv[0], benchmark, benchCase.name, casePath, runs))
+            {
+                std::cerr << "Case " << benchCase.name << " failed to run" << std::endl;
+                return 2;
+            }
+
+        // Keep the fastest run, but whatever any run allocated or peaked at
+        BenchmarkResult result = *std::min_element(runs.begin(), runs.end(),
+            [](const BenchmarkResult& a, const BenchmarkResult& b) {return a.p50Ms < b.p50Ms;});
+
+        for (const BenchmarkResult& run : runs)
+        {
+            result.allocations = std::max(result.allocations, run.allocations);
+            result.peakRssMb = std::max(result.peakRssMb, run.peakRssMb);
+        }
+
+        results.push_back(result);
+        std::cout << benchCase.name << ": " << result.stepsPerSecond << " steps/s, p50 "
+            << result.p50Ms << " ms, p99 " << result.p99Ms << " ms, peak RSS "
+            << result.peakRssMb << " MB, " << result.allocations << " allocations" << std::endl;
+    }
+
+    // Deterministic mode against the plain case of the same size
+    for (const BenchmarkResult& result : results)
+    {
+        if (result.benchCase.variant != BenchmarkVariant::Deterministic)
+            continue;
+
+        auto plain = std::find_if(results.begin(), results.end(),
+            [&result](const BenchmarkResult& other)
+            {
+                return other.benchCase.variant == BenchmarkVariant::Plain
+                    && other.benchCase.boidCount == result.benchCase.boidCount
+                    && other.benchCase.density == result.benchCase.density
+                    && other.benchCase.threadCount == result.benchCase.threadCount;
+            });
+
+        if (plain != results.end())
+            std::cout << "Deterministic mode costs " 
+                << (result.p50Ms / plain->p50Ms - 1) * 100 
+                << "% of median step time over " << plain->benchCase.name << std::endl;
+    }
+
+    size_t allocatingCases = std::count_if(results.begin(), results.end(),
+        [](const BenchmarkResult& result) {return result.allocations != 0;});
+
+    const std::string& writtenPath = updateBaseline ? baselinePath : outputPath;
+    if (!ScalingBenchmark::writeJson(writtenPath, results))
+    {
+        std::cerr << "Could not write " << writtenPath << std::endl;
+        return 2;
+    }
+
+    std::cout << "Wrote " << writtenPath << std::endl;
+    if (allocatingCases != 0)
+    {
+        std::cerr << allocatingCases << " cases allocated while stepping" << std::endl;
+        return 1;
+    }
+
+    if (updateBaseline)
+        return 0;
+
+    std::vector<BenchmarkResult> baseline;
+    if (!ScalingBenchmark::readJson(baselinePath, baseline))
+    {
+        std::cerr << "Could not read " << baselinePath << std::endl;
+        return 2;
+    }
+
+    std::vector<BenchmarkRegression> regressions = 
+        ScalingBenchmark::compare(baseline, results, threshold);
+
+    for (const BenchmarkRegression& regression : regressions)
+        if (regression.missing)
+            std::cerr << "No baseline for " << regression.name << std::endl;
+        else
+            std::cerr << "Regression in " << regression.name << ": p50 " 
+                << regression.p50Ms << " ms, baseline " 
+                << regression.baselineP50Ms << " ms" << std::endl;
+
+    std::cout << regressions.size() << " regressions beyond " 
+        << threshold * 100 << "% or without a baseline" << std::endl;
+
+    return regressions.empty() ? 0 : 1;
+}
@@ -0,0 +1,112 @@
+// Headless 3D scaling benchmark, side by side with 2D
+// Usage: Bench3D [--max-boids count] [--threads count] [--steps count]
+// Prints milliseconds per step of 2D and 3D worlds through their grids,
+// and of 3D by brute force where it stays affordable, at the same average
+// amount of neighbors per boid
+
+#include <chrono>
+#include <cmath>
+#include <cstring>
+#include <iostream>
+#include <string>
+
+#include "BoidWorld.hpp"
+#include "BoidWorld3D.hpp"
+#include "PlayRules.hpp"
+
+// Boids per 100 x 100 area in 2D, and the sense radius of both
+static const float density = 10;
+static const float senseRadius = 40;
+
+// Largest amount of boids stepped by brute force
+static const size_t maxBruteForceBoids = 5000;
+
+// Time a world's steps after a few warm-up ones
+template <typename World>
+static double msPerStep(World& world, size_t step_count)
+{
+    for (size_t stepIter = 0; stepIter < 3; ++stepIter)
+        world.update();
+
+    auto start = std::chrono::steady_clock::now();
+    for (size_t stepIter = 0; stepIter < step_count; ++stepIter)
+        world.update();
+    auto end = std::chrono::steady_clock::now();
+
+    return std::chrono::duration<double>(end - start).count() * 1000.0 / step_count;
+}
+
+static double run2D(size_t boid_count, size_t thread_count, size_t step_count)
+{
+    float side = std::sqrt(boid_count / density) * 100;
+
+    BoidWorld world;
+    setupHeadlessWorld(world, sf::FloatRect(0, 0, side, side), senseRadius);
+    world.setThreadCount(thread_count);
+    world.setBoidCount(boid_count);
+
+    return msPerStep(world, step_count);
+}
+
+static double run3D(size_t boid_count, size_t thread_count, size_t step_count,
+    SpatialIndex spatial_index)
+{
+    // Cube where a sense sphere holds as many boids on average as a sense
+    // disc does in 2D
+    float volume = boid_count * (4.f / 3) * senseRadius * 10000 / density;
+    float side = std::cbrt(volume);
+
+    BoidWorld3D world;
+    world.setBounds(sf::Vector3f(0, 0, 0), sf::Vector3f(side, side, side));
+    setPlayRules(world, senseRadius);
+    world.spatialIndex = spatial_index;
+    world.setThreadCount(thread_count);
+    world.seed = 1;
+    world.setBoidCount(boid_count);
+
+    return msPerStep(world, step_count);
+}
+
+int main(int argc, char* argv[])
+{
+    size_t maxBoidCount = 100000;
+    size_t threadCount = 1;
+    size_t stepCount = 20;
+
+    for (int argIter = 1; argIter < argc; ++argIter)
+    {
+        bool hasValue = argIter + 1 < argc;
+
+        if (!std::strcmp(argv[argIter], "--max-boids") && hasValue)
+            maxBoidCount = std::stoul(argv[++argIter]);
+        else if (!std::strcmp(argv[argIter], "--threads") && hasValue)
+            threadCount = std::stoul(argv[++argIter]);
+        else if (!std::strcmp(argv[argIter], "--steps") && hasValue)
+            stepCount = std::stoul(argv[++argIter]);
+        else
+        {
+            std::cerr << "Unknown argument " << argv[argIter] << std::endl;
+            return 2;
+        }
+    }
+
+    std::cout << "boids,ms2DGrid,ms3DGrid,ms3DBruteForce\n";
+    for (size_t boidCount = 1000; boidCount <= maxBoidCount; boidCount *= 10)
+    for (size_t multiple : {1, 3})
+    {
+        size_t boids = boidCount * multiple;
+        if (boids > maxBoidCount)
+            break;
+
+        std::cout << boids << ","
+            << run2D(boids, threadCount, stepCount) << ","
+            << run3D(boids, threadCount, stepCount, SpatialIndex::Grid) << ",";
+
+        if (boids <= maxBruteForceBoids)
+            std::cout << run3D(boids, threadCount, stepCount, SpatialIndex::BruteForce);
+
+        std::cout << std::endl;
+    }
+
+    return 0;
+}
@@ -0,0 +1,134 @@
+// Headless check of topological neighbor cost as boids crowd together
+// Usage: Clusters [boid_count] [step_count] [max_ratio]
+// Steps the same topological world spread out and packed into squares of
+// shrinking width, checking sampled boids' neighbors against a brute-force
+// search and printing the median milliseconds per step. Fails if neighbors
+// differ, or if any packed world steps more than max_ratio times slower
+// than the spread-out one
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <iostream>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "BoidWorld.hpp"
+#include "PlayRules.hpp"
+#include "SteeringContext.hpp"
+
+// Boids per 100 x 100 area when spread out, and their sense radius
+static const float density = 10;
+static const float senseRadius = 40;
+
+// Steps before timing, and boids whose neighbors get checked per world
+static const size_t warmupSteps = 5;
+static const size_t checkedBoids = 200;
+
+// Check sampled boids' nearest neighbors in the tree against every boid
+static bool checkNeighbors(const BoidWorld& world)
+{
+    SteeringContext context;
+    std::vector<std::pair<float, uint32_t>> expected;
+
+    size_t stride = std::max<size_t>(world.boids.size() / checkedBoids, 1);
+    for (size_t boidIter = 0; boidIter < world.boids.size(); boidIter += stride)
+    {
+        sf::Vector2f position = world.boids[boidIter].getPosition();
+        float radius = world.boids[boidIter].getSenseRadius(world);
+
+        expected.clear();
+        for (size_t otherIter = 0; otherIter < world.boids.size(); ++otherIter)
+        {
+            sf::Vector2f offset = world.boids[otherIter].getPosition() - position;
+            float distSquared = offset.x * offset.x + offset.y * offset.y;
+            if (otherIter != boidIter && distSquared != 0 && distSquared <= radius * radius)
+                expected.emplace_back(distSquared, otherIter);
+        }
+
+        std::sort(expected.begin(), expected.end());
+        expected.resize(std::min(expected.size(), world.topologicalCount));
+
+        world.pointTree.findNearest(position, radius, boidIter,
+            world.topologicalCount, context.nearest);
+        std::sort(context.nearest.begin(), context.nearest.end());
+
+        if (context.nearest != expected)
+            return false;
+    }
+
+    return true;
+}
+
+// Step a world packed into a square of the given width, or spread out if
+// zero, getting the median milliseconds per step and whether neighbors
+// were found exactly
+static double run(size_t boid_count, size_t step_count, float cluster_width, bool& exact)
+{
+    float side = std::sqrt(boid_count / density) * 100;
+
+    BoidWorld world;
+    setupHeadlessWorld(world, sf::FloatRect(0, 0, side, side), senseRadius);
+    world.neighborMode = NeighborMode::Topological;
+    world.setBoidCount(boid_count);
+
+    // Shrink the spread-out placement around the middle of the world
+    if (cluster_width > 0)
+        for (size_t boidIter = 0; boidIter < boid_count; ++boidIter)
+        {
+            sf::Vector2f position = world.boids[boidIter].getPosition();
+            world.boids[boidIter].setPosition(sf::Vector2f(side, side) / 2.f
+                + (position / side - sf::Vector2f(0.5, 0.5)) * cluster_width);
+        }
+
+    for (size_t stepIter = 0; stepIter < warmupSteps; ++stepIter)
+        world.update();
+
+    exact = checkNeighbors(world);
+
+    std::vector<double> stepMs;
+    for (size_t stepIter = 0; stepIter < step_count; ++stepIter)
+    {
+        auto start = std::chrono::steady_clock::now();
+        world.update();
+        auto end = std::chrono::steady_clock::now();
+        stepMs.push_back(std::chrono::duration<double>(end - start).count() * 1000.0);
+    }
+
+    std::sort(stepMs.begin(), stepMs.end());
+    return stepMs[stepMs.size() / 2];
+}
+
+int main(int argc, char* argv[])
+{
+    size_t boidCount = argc > 1 ? std::stoul(argv[1]) : 10000;
+    size_t stepCount = argc > 2 ? std::max<size_t>(std::stoul(argv[2]), 1) : 20;
+    double maxRatio = argc > 3 ? std::stod(argv[3]) : 2;
+
+    // Zero leaves boids spread out
+    const float clusterWidths[] = {0, 60, 20, 5};
+
+    bool passed = true;
+    double spreadMs = 0;
+    for (float clusterWidth : clusterWidths)
+    {
+        bool exact = false;
+        double ms = run(boidCount, stepCount, clusterWidth, exact);
+        if (clusterWidth == 0)
+            spreadMs = ms;
+
+        bool bounded = ms <= spreadMs * maxRatio;
+        passed = passed && exact && bounded;
+
+        std::cout << (clusterWidth == 0 ? std::string("spread out")
+                : "packed into " + std::to_string(int(clusterWidth)) + " px")
+            << ": " << ms << " ms/step" << (exact ? "" : ", neighbors differ")
+            << (bounded ? "" : ", over the bound") << "\n";
+    }
+
+    std::cout << (passed ? "Topological cost stayed bounded\n"
+        : "Topological cost or neighbors went wrong\n");
+
+    return passed ? 0 : 1;
+}
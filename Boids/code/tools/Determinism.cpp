@@ -0,0 +1,85 @@
+// Headless check that deterministic mode steps the same whatever the
+// thread count
+// Usage: Determinism [boid_count] [step_count]
+// Steps the same seed on one thread, two, and one per hardware thread, in
+// every neighbor mode, and compares positions and headings bit for bit.
+// Exits with 1 when any thread count ends up anywhere else
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <iostream>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "BoidWorld.hpp"
+#include "PlayRules.hpp"
+
+// Step a deterministic world on the given amount of threads, getting every
+// boid's position and heading, one after the other
+static std::vector<float> run(size_t boid_count, size_t step_count, 
+    size_t thread_count, NeighborMode neighbor_mode)
+{
+    float side = std::sqrt(boid_count / 10.f) * 100;
+
+    BoidWorld world;
+    setupHeadlessWorld(world, sf::FloatRect(0, 0, side, side), 40);
+    world.neighborMode = neighbor_mode;
+    world.deterministic = true;
+    world.analytics.interval = 10;
+    world.setThreadCount(thread_count);
+    world.setBoidCount(boid_count);
+
+    for (size_t stepIter = 0; stepIter < step_count; ++stepIter)
+        world.update();
+
+    std::vector<float> state;
+    state.reserve(boid_count * 3);
+    for (size_t boidIter = 0; boidIter < boid_count; ++boidIter)
+    {
+        state.push_back(world.boids[boidIter].getPosition().x);
+        state.push_back(world.boids[boidIter].getPosition().y);
+        state.push_back(world.boids[boidIter].getHeading());
+    }
+
+    return state;
+}
+
+int main(int argc, char* argv[])
+{
+    size_t boidCount = argc > 1 ? std::stoul(argv[1]) : 20000;
+    size_t stepCount = argc > 2 ? std::stoul(argv[2]) : 100;
+
+    std::vector<size_t> threadCounts = {1, 2, 
+        std::max<size_t>(std::thread::hardware_concurrency(), 1)};
+    threadCounts.erase(std::unique(threadCounts.begin(), threadCounts.end()), threadCounts.end());
+
+    const NeighborMode modes[] = 
+        {NeighborMode::Metric, NeighborMode::Topological, NeighborMode::Sampled};
+    const char* modeNames[] = {"metric", "topological", "sampled"};
+
+    bool identical = true;
+    for (size_t modeIter = 0; modeIter < std::size(modes); ++modeIter)
+    {
+        std::vector<float> reference = run(boidCount, stepCount, 1, modes[modeIter]);
+
+        for (size_t threadCount : threadCounts)
+        {
+            if (threadCount == 1)
+                continue;
+
+            std::vector<float> state = run(boidCount, stepCount, threadCount, modes[modeIter]);
+            bool same = !std::memcmp(state.data(), reference.data(), state.size() * sizeof(float));
+            identical = identical && same;
+
+            std::cout << modeNames[modeIter] << ", " << threadCount << " threads: " 
+                << (same ? "identical" : "different") << " to 1 thread\n";
+        }
+    }
+
+    std::cout << (identical ? "Every thread count stepped identically\n" 
+        : "Thread counts stepped differently\n");
+
+    return identical ? 0 : 1;
+}
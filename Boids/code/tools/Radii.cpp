@@ -0,0 +1,85 @@
+// Headless comparison of spatial indexes over mixed sense radii
+// Usage: Radii [boid_count] [step_count] [far_ratio]
+// Gives one in far_ratio boids a sense radius sixteen times the rest's,
+// then steps the same deterministic world through every spatial index, and
+// through the grid with cells fitting either radius, checking they all end
+// up bit-identical and printing milliseconds per step
+
+#include <chrono>
+#include <cmath>
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include "BoidWorld.hpp"
+#include "PlayRules.hpp"
+
+// Boids per 100 x 100 area, and the sense radius of near- and far-sighted
+// boids
+static const float density = 100;
+static const float nearRadius = 10;
+static const float farRadius = 160;
+
+// Step a world through the given index, getting milliseconds per step and
+// where every boid ended up
+static double run(size_t boid_count, size_t step_count, size_t far_ratio,
+    SpatialIndex spatial_index, float cell_size, std::vector<sf::Vector2f>& positions)
+{
+    float side = std::sqrt(boid_count / density) * 100;
+
+    BoidWorld world;
+    setupHeadlessWorld(world, sf::FloatRect(0, 0, side, side), nearRadius);
+    world.spatialIndex = spatial_index;
+    world.gridCellSize = cell_size;
+    world.deterministic = true;
+    world.setBoidCount(boid_count);
+
+    for (size_t boidIter = 0; boidIter < boid_count; boidIter += far_ratio)
+        world.boids[boidIter].setSenseRadius(farRadius);
+
+    auto start = std::chrono::steady_clock::now();
+    for (size_t stepIter = 0; stepIter < step_count; ++stepIter)
+        world.update();
+    auto end = std::chrono::steady_clock::now();
+
+    positions.resize(boid_count);
+    for (size_t boidIter = 0; boidIter < boid_count; ++boidIter)
+        positions[boidIter] = world.boids[boidIter].getPosition();
+
+    return std::chrono::duration<double>(end - start).count() * 1000.0 / step_count;
+}
+
+int main(int argc, char* argv[])
+{
+    size_t boidCount = argc > 1 ? std::stoul(argv[1]) : 20000;
+    size_t stepCount = argc > 2 ? std::stoul(argv[2]) : 50;
+    size_t farRatio = argc > 3 ? std::max<size_t>(std::stoul(argv[3]), 1) : 20;
+
+    const SpatialIndex indexes[] = {SpatialIndex::Grid, SpatialIndex::Grid, 
+        SpatialIndex::HashedGrid, SpatialIndex::Hierarchical, SpatialIndex::BruteForce};
+    const float cellSizes[] = {nearRadius, farRadius, nearRadius, 0, 0};
+    const char* indexNames[] = {"grid, near cells", "grid, far cells", 
+        "hashed grid", "grid hierarchy", "brute force"};
+
+    // Brute force gets too slow to wait for past a few thousand boids
+    size_t indexCount = boidCount <= 5000 ? 5 : 4;
+
+    std::vector<sf::Vector2f> reference, positions;
+    bool identical = true;
+    for (size_t indexIter = 0; indexIter < indexCount; ++indexIter)
+    {
+        double ms = run(boidCount, stepCount, farRatio, 
+            indexes[indexIter], cellSizes[indexIter], positions);
+
+        if (indexIter == 0)
+            reference = positions;
+        identical = identical && positions == reference;
+
+        std::cout << indexNames[indexIter] << ": " << ms << " ms/step\n";
+    }
+
+    std::cout << (identical ? "Every index stepped identically\n" 
+        : "Indexes stepped differently\n");
+
+    return identical ? 0 : 1;
+}
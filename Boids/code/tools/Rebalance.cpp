@@ -0,0 +1,62 @@
+// Headless check that steering regions follow the flock
+// Usage: Rebalance [boid_count] [thread_count]
+// Cuts regions over evenly spread boids, then packs every boid into one
+// corner and steps on, expecting the busy times of workers to drift apart
+// and regions to be recut within a few imbalance checks. Exits with 1 when
+// they never are
+
+#include <algorithm>
+#include <iostream>
+#include <string>
+
+#include "BoidWorld.hpp"
+#include "PlayRules.hpp"
+
+int main(int argc, char* argv[])
+{
+    size_t boidCount = argc > 1 ? std::stoul(argv[1]) : 20000;
+    size_t threadCount = argc > 2 ? std::max<size_t>(std::stoul(argv[2]), 2) : 4;
+
+    BoidWorld world;
+    setupHeadlessWorld(world, sf::FloatRect(0, 0, 2000, 2000), 20);
+    world.decomposition.enabled = true;
+    world.setThreadCount(threadCount);
+    world.setBoidCount(boidCount);
+
+    // Regions get cut for the even spread on the first step
+    world.update();
+    size_t initialCuts = world.decomposition.getRebalanceCount();
+
+    // Pack everyone into the top left corner, which a single region holds
+    for (size_t boidIter = 0; boidIter < boidCount; ++boidIter)
+    {
+        sf::Vector2f position = world.boids[boidIter].getPosition();
+        world.boids[boidIter].setPosition(position.x / 8, position.y / 8);
+    }
+
+    size_t checks = 4;
+    size_t stepCount = world.decomposition.rebalanceInterval * checks;
+    size_t recutStep = 0;
+    for (size_t stepIter = 0; stepIter < stepCount && recutStep == 0; ++stepIter)
+    {
+        world.update();
+        if (world.decomposition.getRebalanceCount() > initialCuts)
+            recutStep = stepIter + 1;
+    }
+
+    if (recutStep == 0)
+    {
+        std::cerr << "Regions were never recut within " << stepCount 
+            << " steps of clustering, imbalance " << world.getSteerImbalance() << std::endl;
+        return 1;
+    }
+
+    std::cout << "Regions recut " << recutStep << " steps after clustering, imbalance now "
+        << world.getSteerImbalance() << std::endl;
+
+    // Give the new regions a step to show they even out
+    world.update();
+    std::cout << "Imbalance after the recut: " << world.getSteerImbalance() << std::endl;
+
+    return 0;
+}
@@ -0,0 +1,121 @@
+// Headless accuracy and cost of sampled neighborhoods against exact ones
+// Usage: Sampling [csv_path] [boid_count]
+// Writes one row per sample count, ready for plotting error and cost
+// against it
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <fstream>
+#include <iostream>
+#include <string>
+
+#include "BoidWorld.hpp"
+#include "PlayRules.hpp"
+
+// Set up a dense, flocking world like the windowed simulation's
+static void setupWorld(BoidWorld& world, size_t boid_count)
+{
+    setupHeadlessWorld(world, sf::FloatRect(0, 0, 1080, 720), 50);
+    world.setBoidCount(boid_count);
+}
+
+// Steer every boid of a world on copies, timing the whole pass, and gather
+// their desired directions
+static double desiredDirections(const BoidWorld& world, std::vector<float>& directions)
+{
+    Boid::SteeringKernel steer = Boid::selectSteeringKernel(world, false);
+    SteeringContext context;
+
+    directions.resize(world.boids.size());
+    auto start = std::chrono::steady_clock::now();
+    for (size_t boidIter = 0; boidIter < world.boids.size(); ++boidIter)
+    {
+        Boid boid = world.boids[boidIter];
+        (boid.*steer)(world, boidIter, context);
+        directions[boidIter] = boid.hasDesiredDirection() 
+            ? boid.getDesiredDirection() : NAN;
+    }
+    auto end = std::chrono::steady_clock::now();
+
+    return std::chrono::duration<double>(end - start).count();
+}
+
+int main(int argc, char* argv[])
+{
+    std::string csvPath = argc > 1 ? argv[1] : "sampling.csv";
+    size_t boidCount = argc > 2 ? std::stoul(argv[2]) : 5000;
+
+    const size_t sampleCounts[] = {1, 2, 4, 8, 16, 32, 64, 128};
+    const size_t settleSteps = 300, runSteps = 500;
+
+    // Directions are compared on the same, settled flock
+    BoidWorld world;
+    setupWorld(world, boidCount);
+    for (size_t stepIter = 0; stepIter < settleSteps; ++stepIter)
+        world.update();
+
+    std::vector<float> exact, sampled;
+    world.neighborMode = NeighborMode::Metric;
+    double exactSeconds = desiredDirections(world, exact);
+
+    std::ofstream csv(csvPath);
+    if (!csv)
+    {
+        std::cerr << "Could not write " << csvPath << std::endl;
+        return 1;
+    }
+
+    csv << "sampleCount,meanErrorDegrees,p90ErrorDegrees,nsPerBoid,exactNsPerBoid,"
+        << "polarization,exactPolarization\n";
+
+    // Whole runs show how errors add up over time
+    BoidWorld exactRun;
+    setupWorld(exactRun, boidCount);
+    for (size_t stepIter = 0; stepIter < runSteps; ++stepIter)
+        exactRun.update();
+
+    for (size_t sampleCount : sampleCounts)
+    {
+        world.neighborMode = NeighborMode::Sampled;
+        world.sampleCount = sampleCount;
+        double sampledSeconds = desiredDirections(world, sampled);
+
+        // Angular distance to the exact direction, over boids that steer
+        std::vector<float> errors;
+        for (size_t boidIter = 0; boidIter < exact.size(); ++boidIter)
+        {
+            if (std::isnan(exact[boidIter]) || std::isnan(sampled[boidIter]))
+                continue;
+
+            float error = std::fmod(std::abs(exact[boidIter] - sampled[boidIter]), 360.f);
+            errors.push_back(std::min(error, 360.f - error));
+        }
+
+        double meanError = 0;
+        for (float error : errors)
+            meanError += error;
+        meanError /= std::max<size_t>(errors.size(), 1);
+
+        std::sort(errors.begin(), errors.end());
+        float p90Error = errors.empty() ? 0 : errors[errors.size() * 9 / 10];
+
+        BoidWorld sampledRun;
+        setupWorld(sampledRun, boidCount);
+        sampledRun.neighborMode = NeighborMode::Sampled;
+        sampledRun.sampleCount = sampleCount;
+        for (size_t stepIter = 0; stepIter < runSteps; ++stepIter)
+            sampledRun.update();
+
+        csv << sampleCount << "," << meanError << "," << p90Error << ","
+            << sampledSeconds * 1e9 / boidCount << "," << exactSeconds * 1e9 / boidCount << ","
+            << sampledRun.getPolarization() << "," << exactRun.getPolarization() << "\n";
+
+        std::cout << "M = " << sampleCount << ": mean error " << meanError 
+            << " deg, p90 " << p90Error << " deg, " << sampledSeconds * 1e9 / boidCount
+            << " ns/boid (exact " << exactSeconds * 1e9 / boidCount << ")" << std::endl;
+    }
+
+    std::cout << "Wrote " << csvPath << std::endl;
+    return 0;
+}
@@ -0,0 +1,38 @@
+// Headless parameter sweep over independent flocks
+// Usage: Sweep [csv_path] [thread_count]
+
+#include <iostream>
+#include <string>
+
+#include "EnsembleRunner.hpp"
+
+int main(int argc, char* argv[])
+{
+    std::string csvPath = argc > 1 ? argv[1] : "sweep.csv";
+    size_t threadCount = argc > 2 ? std::stoul(argv[2]) : 0;
+
+    // Same play rules as the windowed simulation, swept around its defaults
+    EnsembleRunner runner;
+    runner.cohesionValues = {0.5, 1, 2};
+    runner.allignmentValues = {1, 2, 4};
+    runner.separationValues = {0.5, 1, 2};
+    runner.senseRadiusValues = {25, 50, 100};
+    runner.repeats = 2;
+
+    runner.bounds = sf::FloatRect(0, 0, 1080, 720);
+    runner.boidCount = 100;
+    runner.stepCount = 2000;
+
+    ThreadPool pool(threadCount);
+    std::cout << "Running " << runner.buildRuns().size() << " worlds on "
+        << pool.getThreadCount() << " threads" << std::endl;
+
+    if (!EnsembleRunner::writeCsv(csvPath, runner.run(pool)))
+    {
+        std::cerr << "Could not write " << csvPath << std::endl;
+        return 1;
+    }
+
+    std::cout << "Wrote " << csvPath << std::endl;
+    return 0;
+}
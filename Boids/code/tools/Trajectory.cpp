@@ -0,0 +1,136 @@
+// Headless trajectory recording and read-back
+// Usage: Trajectory [path] [boid_count] [step_count]
+// Records a flock to the given file, then streams a time range for a few
+// boids and for every boid back out, checking positions against the ones
+// simulated and reporting sizes and throughput
+
+#include <chrono>
+#include <cmath>
+#include <iostream>
+#include <string>
+
+#include "BoidWorld.hpp"
+#include "PlayRules.hpp"
+#include "TrajectoryReader.hpp"
+
+// Set up a dense, flocking world like the windowed simulation's
+static void setupWorld(BoidWorld& world, size_t boid_count)
+{
+    setupHeadlessWorld(world, sf::FloatRect(0, 0, 1080, 720), 20);
+    world.setBoidCount(boid_count);
+}
+
+static double secondsSince(std::chrono::steady_clock::time_point start)
+{return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();}
+
+int main(int argc, char* argv[])
+{
+    std::string path = argc > 1 ? argv[1] : "trajectory.bin";
+    size_t boidCount = argc > 2 ? std::stoul(argv[2]) : 10000;
+    size_t stepCount = argc > 3 ? std::stoul(argv[3]) : 1000;
+
+    // Read back the middle fifth of the run, for every 100th boid
+    size_t firstStep = stepCount * 2 / 5 + 1, lastStep = stepCount * 3 / 5;
+    std::vector<BoidStorage::BoidId> sampledIds;
+    for (size_t boidIter = 0; boidIter < boidCount; boidIter += 100)
+        sampledIds.push_back(boidIter);
+
+    // Same run without recording, for the overhead
+    double plainSeconds;
+    {
+        BoidWorld world;
+        setupWorld(world, boidCount);
+
+        auto start = std::chrono::steady_clock::now();
+        for (size_t stepIter = 0; stepIter < stepCount; ++stepIter)
+            world.update();
+        plainSeconds = secondsSince(start);
+    }
+
+    BoidWorld world;
+    setupWorld(world, boidCount);
+    if (!world.trajectory.open(path))
+    {
+        std::cerr << "Could not write " << path << std::endl;
+        return 1;
+    }
+
+    // Keep what the sampled boids did within the range, to check against
+    std::vector<sf::Vector2f> expected;
+    auto start = std::chrono::steady_clock::now();
+    for (size_t stepIter = 0; stepIter < stepCount; ++stepIter)
+    {
+        world.update();
+
+        if (world.stepCount >= firstStep && world.stepCount <= lastStep)
+            for (BoidStorage::BoidId id : sampledIds)
+                expected.push_back(world.boids[world.boids.getIndex(id)].getPosition());
+    }
+
+    if (!world.trajectory.close())
+    {
+        std::cerr << "Writing " << path << " failed" << std::endl;
+        return 1;
+    }
+    double recordSeconds = secondsSince(start);
+
+    size_t fileBytes = world.trajectory.getWrittenBytes();
+    std::cout << "Recorded " << boidCount << " boids over " << stepCount << " steps: "
+        << fileBytes / 1e6 << " MB, " << double(fileBytes) / (boidCount * stepCount)
+        << " bytes per boid and step (raw floats take " << sizeof(sf::Vector2f) << "), "
+        << "stepping took " << (recordSeconds / plainSeconds - 1) * 100 << "% longer\n";
+
+    TrajectoryReader reader;
+    if (!reader.open(path))
+    {
+        std::cerr << "Could not read " << path << std::endl;
+        return 1;
+    }
+
+    // Tracks of a boid come in step order, chunk after chunk
+    std::vector<std::vector<sf::Vector2f>> tracks(boidCount);
+    auto collect = [&](BoidStorage::BoidId id, size_t, const std::vector<sf::Vector2f>& positions)
+        {tracks[id].insert(tracks[id].end(), positions.begin(), positions.end());};
+
+    start = std::chrono::steady_clock::now();
+    if (!reader.read(firstStep, lastStep, sampledIds, collect))
+    {
+        std::cerr << path << " is malformed" << std::endl;
+        return 1;
+    }
+    double subsetSeconds = secondsSince(start);
+
+    double maxError = 0;
+    size_t rangeSteps = lastStep - firstStep + 1;
+    for (size_t sampledIter = 0; sampledIter < sampledIds.size(); ++sampledIter)
+    {
+        const std::vector<sf::Vector2f>& track = tracks[sampledIds[sampledIter]];
+        if (track.size() != rangeSteps)
+        {
+            std::cerr << "Boid " << sampledIds[sampledIter] << " got " << track.size()
+                << " positions instead of " << rangeSteps << std::endl;
+            return 1;
+        }
+
+        for (size_t stepIter = 0; stepIter < rangeSteps; ++stepIter)
+        {
+            sf::Vector2f error = track[stepIter] - expected[stepIter * sampledIds.size() + sampledIter];
+            maxError = std::max<double>(maxError, std::hypot(error.x, error.y));
+        }
+    }
+
+    size_t decoded = 0;
+    start = std::chrono::steady_clock::now();
+    reader.read(firstStep, lastStep, {},
+        [&](BoidStorage::BoidId, size_t, const std::vector<sf::Vector2f>& positions)
+        {decoded += positions.size();});
+    double everySeconds = secondsSince(start);
+
+    std::cout << "Steps " << firstStep << " to " << lastStep << ": "
+        << sampledIds.size() << " boids in " << subsetSeconds * 1000.0 << " ms, "
+        << "largest error " << maxError << " (quantum " << reader.getQuantum() << "), "
+        << "every boid in " << everySeconds * 1000.0 << " ms, "
+        << decoded / everySeconds / 1e6 << " M positions/s\n";
+
+    return 0;
+}